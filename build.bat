@@ -10,7 +10,7 @@ set i=/I %l%
 
 
 set GLAD_SOURCE=%l%glad\src\glad.c
-set SOURCE=%s%proj_main.cpp %s%proj_sound.cpp %s%proj_math.cpp %GLAD_SOURCE%
+set SOURCE=%s%proj_main.cpp %s%proj_sound.cpp %s%proj_math.cpp %s%proj_board.cpp %s%proj_solver.cpp %s%proj_canon.cpp %s%proj_stats.cpp %s%proj_verify.cpp %s%proj_pool.cpp %s%proj_count.cpp %s%proj_grids.cpp %s%proj_logic.cpp %s%proj_unavoid.cpp %s%proj_prefetch.cpp %GLAD_SOURCE%
 set INCLUDES=%i%glfw_33_x64\include\ %i%glad\include\ %i%stb\ 
 
 set LIBRARIES=kernel32.lib gdi32.lib shell32.lib msvcrt.lib libcmt.lib user32.lib Comdlg32.lib ole32.lib opengl32.lib %l%glfw_33_x64\lib-vc2019\glfw3.lib %l%glfw_33_x64\lib-vc2019\glfw3dll.lib 
@@ -22,6 +22,8 @@ if "%1" == "--test" goto TESTING
 if "%1" == "-d"      goto DEBUGGING
 if "%1" == "--debug" goto DEBUGGING
 
+if "%1" == "-tool"   goto TOOL
+
 echo [Release Enabled]
 echo.
 set ARGS=/O2
@@ -31,18 +33,29 @@ goto COMPILE
 :TESTING
     echo [Tests Enabled]
     echo.
-    set ARGS=/Zi /DTESTING_ENABLE
+    set ARGS=/Zi /DTESTING_ENABLE /DSTATS_ENABLE
     set LINK_ARGS=/SUBSYSTEM:CONSOLE
     goto COMPILE
 :DEBUGGING
     echo [Debug Enabled]
     echo.
-    set ARGS=/Zi /DDEBUG_ENABLE
+    set ARGS=/Zi /DDEBUG_ENABLE /DSTATS_ENABLE
+    set LINK_ARGS=/SUBSYSTEM:CONSOLE
+    goto COMPILE
+
+:TOOL
+    echo [Tool Enabled]
+    echo.
+    set NAME=sudoku_tool
+    set SOURCE=%s%proj_tool.cpp %s%proj_board.cpp %s%proj_solver.cpp %s%proj_canon.cpp %s%proj_stats.cpp %s%proj_pool.cpp %s%proj_logic.cpp %s%proj_unavoid.cpp %s%proj_lowclue.cpp %s%proj_batch.cpp %s%proj_count.cpp
+    set INCLUDES=
+    set LIBRARIES=kernel32.lib
+    set ARGS=/O2
     set LINK_ARGS=/SUBSYSTEM:CONSOLE
     goto COMPILE
 
 :COMPILE
-set NAME=sudoku
+if not defined NAME set NAME=sudoku
 cl %ARGS% /nologo /F 2000000 /Fe%NAME%.exe %INCLUDES% %SOURCE% /link %LIBRARIES% %LINK_ARGS%
 if ERRORLEVEL 1 (
 	popd
@@ -50,6 +63,7 @@ if ERRORLEVEL 1 (
 )
 
 echo.
+if "%1" == "-tool"   goto CONCLUDE
 
 :ICON
 WHERE rcedit-x64.exe >nul 2>nul
@@ -0,0 +1,108 @@
+#include "proj_batch.h"
+
+
+// -- Queue
+// waits only when the writer is a whole ring behind
+void _batch_push(BatchQueue* q, u32 n, const u16* board) {
+    BatchSlot* slot = &q->slots[n % BATCH_QUEUE];
+    while (u32(slot->turn) != n) WaitForSingleObject(slot->released, INFINITE);
+
+    for (u8 i = 0; i < BOARD_SIZE; i++) slot->line[i] = '0' + BIT_DIGIT(board[i]);
+    slot->line[BOARD_SIZE] = '\n';
+    InterlockedExchange(&slot->ready, 1);
+    SetEvent(slot->filled);
+}
+
+// later puzzles may be done first, the oldest is at most one dig behind
+BatchSlot* _batch_pop(BatchQueue* q) {
+    BatchSlot* slot = &q->slots[q->head % BATCH_QUEUE];
+    while (!slot->ready) WaitForSingleObject(slot->filled, INFINITE);
+    return slot;
+}
+
+void _batch_release(BatchQueue* q, BatchSlot* slot) {
+    InterlockedExchange(&slot->ready, 0);
+    InterlockedExchange(&slot->turn, long(q->head + BATCH_QUEUE));
+    SetEvent(slot->released);
+    q->head++;
+}
+
+
+
+// -- Threads
+void _batch_task(void* args, u32 index, u32 worker) {
+    BatchJob* job = (BatchJob*) args;
+    Rng rng;
+    u32 n;
+
+    while ((n = u32(InterlockedIncrement(&job->claimed)) - 1) < job->count) {
+        u16 board[BOARD_SIZE];
+        rng_seed(&rng, job->seed, n);
+        u32 score = generate_puzzle(board, job->range, job->budget_us, job->symmetry, &rng, &job->worker_stats[worker]);
+        if (score < job->range.lo) InterlockedIncrement(&job->missed);
+        _batch_push(&job->queue, n, board);
+    }
+}
+
+DWORD _batch_writer(BatchJob* job) {
+    BatchQueue* q = &job->queue;
+    u64 start  = stats_ticks();
+    u64 report = start;
+
+    while (job->written < job->count) {
+        BatchSlot* slot = _batch_pop(q);
+        fwrite(slot->line, 1, BATCH_LINE, job->out);
+        _batch_release(q, slot);
+        job->written++;
+
+        u64 now = stats_ticks();
+        if (stats_ticks_to_ns(now - report) >= u64(BATCH_REPORT_MS) * 1000000) {
+            f64 seconds = f64(stats_ticks_to_ns(now - start)) / 1e9;
+            fprintf(stderr, "[Batch] %u / %u puzzles :: %.1f puzzles/s\n", job->written, job->count, f64(job->written) / seconds);
+            report = now;
+        }
+    }
+    fflush(job->out);
+    return 0;
+}
+
+u32 batch_generate(BatchJob* job, ThreadPool* pool) {
+    BatchQueue* q = &job->queue;
+    q->head = 0;
+    for (u32 i = 0; i < BATCH_QUEUE; i++) {
+        q->slots[i].turn     = long(i);
+        q->slots[i].ready    = 0;
+        q->slots[i].filled   = CreateEvent(NULL, FALSE, FALSE, NULL);
+        q->slots[i].released = CreateEvent(NULL, FALSE, FALSE, NULL);
+    }
+
+    job->claimed = 0;
+    job->missed  = 0;
+    job->written = 0;
+    stats_reset(&job->stats);
+    job->worker_stats = (SolverStats*) malloc(sizeof(SolverStats) * pool->n_threads);
+    for (u32 t = 0; t < pool->n_threads; t++) stats_reset(&job->worker_stats[t]);
+
+    u64 start = stats_ticks();
+    HANDLE writer = CreateThread(NULL, 0, (LPTHREAD_START_ROUTINE) _batch_writer, job, 0, NULL);
+
+    // one generator per thread, each runs until the count is claimed. no
+    // more than the ring has slots, so a slot never has two waiting
+    u32 generators = (pool->n_threads < BATCH_QUEUE) ? pool->n_threads : BATCH_QUEUE;
+    pool_run(pool, _batch_task, job, generators);
+    for (u32 t = 0; t < pool->n_threads; t++) stats_merge(&job->stats, &job->worker_stats[t]);
+    free(job->worker_stats);
+    job->worker_stats = NULL;
+
+    WaitForSingleObject(writer, INFINITE);
+    CloseHandle(writer);
+    job->ticks = stats_ticks() - start;
+
+    for (u32 i = 0; i < BATCH_QUEUE; i++) {
+        CloseHandle(q->slots[i].filled);
+        CloseHandle(q->slots[i].released);
+        q->slots[i].filled   = NULL;
+        q->slots[i].released = NULL;
+    }
+    return job->written;
+}
@@ -0,0 +1,82 @@
+#ifndef PROJ_BATCH_H
+#define PROJ_BATCH_H
+
+// local
+#include "proj_types.h"
+#include "proj_board.h"
+#include "proj_pool.h"
+#include "proj_stats.h"
+
+// third party
+#include "windows.h"
+
+// system
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+
+
+/*
+    batch generation
+
+    every thread of the pool runs generate_puzzle in a loop and hands the
+    puzzles to a bounded ring. a single writer thread takes them off in
+    order and writes one 81 character line per puzzle (0 for an empty
+    cell). a full ring holds the generators back, so a slow disk can't
+    pile lines up in memory.
+
+    puzzle n is dug from its own stream of the job's seed and goes to slot
+    n of the ring once the writer is done with n - BATCH_QUEUE, so the file
+    comes out in index order. untimed, the same seed writes the same file
+    on any number of threads. every generator counts into stats of its
+    own, merged into the job's once the pool is done.
+
+    nothing polls. a slot has an auto reset event for each direction, the
+    generator sets filled once its line is in, the writer sets released
+    once it has moved the slot's turn on. a generator only waits for the
+    slot of a puzzle a whole ring ahead of the writer, so with at most
+    BATCH_QUEUE generators there's never a second one on the same slot.
+    an event left set by a wait that didn't need it only costs a recheck.
+*/
+#define BATCH_QUEUE             256         // lines in the ring
+#define BATCH_LINE              (BOARD_SIZE + 1)
+#define BATCH_REPORT_MS         1000
+
+struct BatchSlot {
+    char          line[BATCH_LINE];
+    volatile long turn;                     // the puzzle this slot waits for
+    volatile long ready;
+    HANDLE        filled   = NULL;          // set by the generator, line is in
+    HANDLE        released = NULL;          // set by the writer, turn moved on
+};
+
+struct BatchQueue {
+    BatchSlot     slots[BATCH_QUEUE];
+    u32           head = 0;                 // next puzzle to write, writer only
+};
+
+struct BatchJob {
+    // settings
+    u32             count     = 0;
+    DifficultyRange range     = difficulty_ranges[DIFFICULTY_MEDIUM];
+    u8              symmetry  = SYMMETRY_NONE;
+    u64             seed      = 0;
+    u64             budget_us = GENERATE_BUDGET_US;     // GENERATE_UNTIMED for a reproducible run
+    FILE*           out       = NULL;
+
+    // progress
+    volatile long   claimed   = 0;
+    volatile long   missed    = 0;          // out of budget before the band
+    u32             written   = 0;
+    u64             ticks     = 0;
+    SolverStats     stats;                  // filled in with STATS_ENABLE
+    SolverStats*    worker_stats = NULL;    // one per pool thread, during the run
+
+    BatchQueue      queue;
+};
+
+// blocks until job->count lines are written, returns how many
+u32 batch_generate(BatchJob* job, ThreadPool* pool);
+
+#endif
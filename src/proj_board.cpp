@@ -0,0 +1,1298 @@
+#include "proj_board.h"
+#include "proj_solver.h"
+#include "proj_logic.h"
+#include "proj_unavoid.h"
+
+// SSE2 is always there on x64
+#include <emmintrin.h>
+
+// -- Layout
+void board_to_render(u16* board, u16* render) {
+    for (u8 y = 0; y < BOARD_DIM; y++) {
+        for (u8 x = 0; x < BOARD_DIM; x++) {
+            render[RENDER_IDX(x,y)] = board[IDX(x,y)];
+        }
+    }
+}
+
+void render_to_board(u16* render, u16* board) {
+    for (u8 y = 0; y < BOARD_DIM; y++) {
+        for (u8 x = 0; x < BOARD_DIM; x++) {
+            board[IDX(x,y)] = render[RENDER_IDX(x,y)];
+        }
+    }
+}
+
+
+// -- Validation
+u8 _check(u16* board_data, u8 unit) {
+    u16 cache[9][9];
+    u8  indices[9];
+
+    // clear cache
+    for (u8 j = 0; j < 9; j++) {
+        indices[j] = 0;
+        for (u8 i = 0; i < 9; i++) {
+            cache[i][j] = 0;
+        }
+    }
+    
+    // record values
+    for (u8 k = 0; k < 9; k++) {
+        u16 idx = UNIT_CELLS(unit)[k];
+        for (u8 n = 0; n < 9; n++) {
+            if (board_data[idx] & (1<<n)) {
+                cache[n][indices[n]] = idx;
+                indices[n]++;
+            }
+        }
+    }
+
+    // check errors
+    u8 score = 0;
+    for (u8 n = 0; n < 9; n++) {
+        if (indices[n] < 2) {
+            if (indices[n] > 0) score++;
+            continue;
+        }
+
+        // count members statics
+        u8 entered_set = 0;
+        u8 static_set  = 0;
+        for (u8 i = 0; i < 9; i++) {
+            if (i >= indices[n]) break;
+            if (!(board_data[cache[n][i]] & BOARD_ALL)) continue;
+            if (!(board_data[cache[n][i]] & BOARD_FLAG_PENCIL)) entered_set++;
+            if   (board_data[cache[n][i]] & BOARD_FLAG_STATIC)  static_set++;
+        }
+        
+        // enter errors
+        for (u8 i = 0; i < 9; i++) {
+            if (i >= indices[n]) break;
+            if (board_data[cache[n][i]] & BOARD_FLAG_PENCIL) {
+                if (static_set > u8((board_data[cache[n][i]] & BOARD_FLAG_STATIC) != 0) ) {
+                    board_data[cache[n][i]] |= BOARD_FLAG_ERROR;
+                }
+            } else {
+                if ((entered_set + static_set) > 1) {
+                    board_data[cache[n][i]] |= BOARD_FLAG_ERROR;
+                }
+            }
+        }
+    }
+
+    return score;
+}
+
+u8 validate_board_units(u16* board_data) {
+    // clear errors and solves
+    for (u8 i = 0; i < BOARD_SIZE; i++) {
+        board_data[i] &= ~u16(BOARD_FLAG_ERROR | BOARD_FLAG_SOLVE);
+    }
+
+    // each check is worth 9
+    // - 9 square checks
+    // - 9 row checks
+    // - 9 col checks
+    // => success = 9 * 9 * 3
+    u32 score = 0;
+
+    // check squares, rows and cols
+    for (u8 unit = 0; unit < N_UNITS; unit++) {
+        score += _check(board_data, unit);
+    }
+
+    // solve check
+    if (score >= 9*9*3) {
+        for (u8 i = 0; i < BOARD_SIZE; i++) {
+            if (!(board_data[i] & BOARD_FLAG_STATIC)) {
+                board_data[i] &= ~u16(BOARD_FLAG_PENCIL);
+                board_data[i] |= BOARD_FLAG_SOLVE;
+            }
+        }
+        return 1;
+    }
+    return 0;
+}
+
+
+
+/*
+    every unit keeps, per digit, whether one or at least two of its cells
+    hold it: any cell, entered (non pencil) cells and static cells, packed
+    10 bits apart so one count covers all three. a digit held twice is an
+    error for the entered cells holding it when two entered or static cells
+    do, and for pencils once a static cell does (another one, for static
+    pencils). the unit is complete when every digit is held exactly once.
+*/
+#define PACK_ANY        0
+#define PACK_ENTERED    10
+#define PACK_STATICS    20
+
+#define COUNT_BITS(once, twice, v) {\
+    (twice) |= (once) & (v);\
+    (once)  |= (v);\
+}
+
+// the digits times the copies the flags make, indexed by pencil (bit 2) and static (bit 0)
+constexpr u32 pack_copies[8] = {
+    (1 << PACK_ANY) | (1 << PACK_ENTERED),  (1 << PACK_ANY) | (1 << PACK_ENTERED) | (1 << PACK_STATICS),  0, 0,
+    (1 << PACK_ANY),                        (1 << PACK_ANY) | (1 << PACK_STATICS),                         0, 0,
+};
+
+u32 _pack_cell(u16 cell) {
+    return u32(cell & BOARD_ALL) * pack_copies[(cell >> 13) & 0x5];     // BOARD_FLAG_PENCIL >> 13 is 4, BOARD_FLAG_STATIC >> 13 is 1
+}
+
+// digits that are an error for entered cells, pencils and static pencils, 16 bits apart
+u64 _unit_errors(u32 once, u32 twice) {
+    u64 any_twice      = (twice >> PACK_ANY)     & BOARD_ALL;
+    u64 entered_once   = (once  >> PACK_ENTERED) & BOARD_ALL;
+    u64 entered_twice  = (twice >> PACK_ENTERED) & BOARD_ALL;
+    u64 statics_once   = (once  >> PACK_STATICS) & BOARD_ALL;
+    u64 statics_twice  = (twice >> PACK_STATICS) & BOARD_ALL;
+
+    return ((any_twice & (entered_twice | statics_twice | (entered_once & statics_once))))
+         | ((any_twice & statics_once)  << 16)
+         | ((any_twice & statics_twice) << 32);
+}
+
+u8 _unit_complete(u32 once, u32 twice) {
+    return !((((once >> PACK_ANY) & BOARD_ALL) ^ BOARD_ALL) | ((twice >> PACK_ANY) & BOARD_ALL));
+}
+
+// units holds the errors of the cell's three units or'ed together
+u16 _cell_error(u16 cell, u64 units) {
+    // 0 entered, 1 pencil, 2 static pencil
+    u8 kind = u8((cell & BOARD_FLAG_PENCIL) != 0) << u8((cell & BOARD_FLAG_STATIC) != 0);
+    return u16(((units >> (16 * kind)) & cell & BOARD_ALL) != 0);
+}
+
+// error and solve flags as validate_board leaves them
+u16 _flag_cell(u16 cell, u16 error, u8 solved) {
+    cell &= ~u16(BOARD_FLAG_ERROR | BOARD_FLAG_SOLVE);
+    u16 solve = (u16(0) - u16(solved)) & (u16(0) - u16(!(cell & BOARD_FLAG_STATIC)));
+    return (cell & ~(solve & BOARD_FLAG_PENCIL)) | (solve & BOARD_FLAG_SOLVE) | ((u16(0) - error) & BOARD_FLAG_ERROR);
+}
+
+// errors of every unit, 1 if every unit is complete
+u8 _check_units(u16* board_data, u64* errors) {
+    u32 once[N_UNITS]  = {0};
+    u32 twice[N_UNITS] = {0};
+
+    // a row stays in registers, cols and boxes are a few cells apart
+    for (u8 y = 0; y < BOARD_DIM; y++) {
+        u32 row_once  = 0;
+        u32 row_twice = 0;
+        for (u8 x = 0; x < BOARD_DIM; x++) {
+            u32 v   = _pack_cell(board_data[IDX(x,y)]);
+            u8  col = UNIT_COL(x);
+            u8  box = UNIT_BOX((y / 3) * 3 + x / 3);
+            COUNT_BITS(row_once,   row_twice,   v);
+            COUNT_BITS(once[col],  twice[col],  v);
+            COUNT_BITS(once[box],  twice[box],  v);
+        }
+        once[UNIT_ROW(y)]  = row_once;
+        twice[UNIT_ROW(y)] = row_twice;
+    }
+
+    u8 complete = 1;
+    for (u8 u = 0; u < N_UNITS; u++) {
+        errors[u] = _unit_errors(once[u], twice[u]);
+        complete &= _unit_complete(once[u], twice[u]);
+    }
+    return complete;
+}
+
+void check_board(u16* board_data, BoardCheck* out) {
+    u64 errors[N_UNITS];
+    out->solved = _check_units(board_data, errors);
+
+    out->errors[0] = 0;
+    out->errors[1] = 0;
+    for (u8 y = 0; y < BOARD_DIM; y++) {
+        for (u8 x = 0; x < BOARD_DIM; x++) {
+            u8  i     = IDX(x,y);
+            u64 units = errors[UNIT_ROW(y)] | errors[UNIT_COL(x)] | errors[UNIT_BOX((y / 3) * 3 + x / 3)];
+            out->errors[i >> 6] |= u64(_cell_error(board_data[i], units)) << (i & 63);
+        }
+    }
+}
+
+/*
+    the flags go on eight cells of a row at a time (cols 0-7, col 8 on its
+    own). the errors of the three kinds are split into their own 16 bit
+    lanes, so a row is the broadcast of its unit, the cols are one load and
+    the boxes of a band are three lanes each. pencil and static flags are
+    the top bits of a cell, shifted up to the sign they make lane masks.
+*/
+u8 validate_board(u16* board_data) {
+    u64 errors[N_UNITS];
+    u16 solved = _check_units(board_data, errors);
+
+    u16 kinds[3][N_UNITS];
+    for (u8 u = 0; u < N_UNITS; u++) {
+        for (u8 k = 0; k < 3; k++) kinds[k][u] = u16(errors[u] >> (16 * k));
+    }
+
+    __m128i digits = _mm_set1_epi16(BOARD_ALL);
+    __m128i flags  = _mm_set1_epi16(short(BOARD_FLAG_ERROR | BOARD_FLAG_SOLVE));
+    __m128i pencil = _mm_set1_epi16(short(BOARD_FLAG_PENCIL));
+    __m128i solve  = _mm_set1_epi16(short(BOARD_FLAG_SOLVE));
+    __m128i error  = _mm_set1_epi16(short(BOARD_FLAG_ERROR));
+    __m128i done   = _mm_set1_epi16(short(0 - solved));
+
+    __m128i cols[3];
+    __m128i boxes[3];
+    for (u8 k = 0; k < 3; k++) cols[k] = _mm_loadu_si128((__m128i*) &kinds[k][UNIT_COL(0)]);
+
+    for (u8 y = 0; y < BOARD_DIM; y++) {
+        if (y % 3 == 0) {
+            for (u8 k = 0; k < 3; k++) {
+                u16* box = &kinds[k][UNIT_BOX(y)];
+                boxes[k] = _mm_setr_epi16(box[0], box[0], box[0], box[1], box[1], box[1], box[2], box[2]);
+            }
+        }
+
+        __m128i cells   = _mm_loadu_si128((__m128i*) &board_data[IDX(0,y)]);
+        __m128i pencils = _mm_srai_epi16(cells, 15);                        // BOARD_FLAG_PENCIL is bit 15
+        __m128i statics = _mm_srai_epi16(_mm_slli_epi16(cells, 2), 15);     // BOARD_FLAG_STATIC is bit 13
+
+        __m128i units[3];
+        for (u8 k = 0; k < 3; k++) {
+            units[k] = _mm_or_si128(_mm_or_si128(cols[k], boxes[k]), _mm_set1_epi16(short(kinds[k][UNIT_ROW(y)])));
+        }
+
+        // entered cells by the first kind, pencils by the second or third
+        __m128i pencil_units = _mm_or_si128(_mm_andnot_si128(statics, units[1]), _mm_and_si128(statics, units[2]));
+        __m128i cell_units   = _mm_or_si128(_mm_andnot_si128(pencils, units[0]), _mm_and_si128(pencils, pencil_units));
+        __m128i clean        = _mm_cmpeq_epi16(_mm_and_si128(_mm_and_si128(cell_units, cells), digits), _mm_setzero_si128());
+        __m128i solving      = _mm_andnot_si128(statics, done);
+
+        cells = _mm_andnot_si128(flags, cells);
+        cells = _mm_andnot_si128(_mm_and_si128(solving, pencil), cells);
+        cells = _mm_or_si128(cells, _mm_and_si128(solving, solve));
+        cells = _mm_or_si128(cells, _mm_andnot_si128(clean, error));
+        _mm_storeu_si128((__m128i*) &board_data[IDX(0,y)], cells);
+
+        u8  i      = IDX(8,y);
+        u64 units8 = errors[UNIT_ROW(y)] | errors[UNIT_COL(8)] | errors[UNIT_BOX((y / 3) * 3 + 2)];
+        board_data[i] = _flag_cell(board_data[i], _cell_error(board_data[i], units8), u8(solved));
+    }
+    return u8(solved);
+}
+
+
+
+// -- Incremental Validation
+#define COUNTED_BITS    (BOARD_ALL | BOARD_FLAG_PENCIL | BOARD_FLAG_STATIC)
+
+// bit-sliced add (or take back) of a cell's packed digits, on each of its units
+void _validator_count(BoardValidator* v, u8 idx, u16 cell, u8 add) {
+    u32 packed = _pack_cell(cell);
+    u32 flip   = u32(0) - u32(!add);
+    for (u8 k = 0; k < 3; k++) {
+        u32* planes = v->planes[CELL_UNITS(idx)[k]];
+        u32  carry  = packed;
+        for (u8 p = 0; p < 4; p++) {
+            u32 next   = (planes[p] ^ flip) & carry;
+            planes[p] ^= carry;
+            carry      = next;
+        }
+    }
+}
+
+void _validator_unit(BoardValidator* v, u8 unit) {
+    u32* planes = v->planes[unit];
+    u32  twice  = planes[1] | planes[2] | planes[3];
+    u32  once   = planes[0] | twice;
+
+    u8 complete = _unit_complete(once, twice);
+    v->n_complete    += complete - v->complete[unit];
+    v->complete[unit] = complete;
+    v->errors[unit]   = _unit_errors(once, twice);
+}
+
+void validator_reset(BoardValidator* v) {
+    v->valid = 0;
+}
+
+u8 validate_incremental(BoardValidator* v, u16* board_data) {
+#ifdef DEBUG_ENABLE
+    u16 full[BOARD_SIZE];
+    memcpy(full, board_data, sizeof(full));
+    u8 full_solved = validate_board(full);
+#endif
+
+    u32 dirty_units    = 0;
+    u64 dirty_cells[2] = {0, 0};
+
+    if (!v->valid) {
+        memset(v->planes,   0, sizeof(v->planes));
+        memset(v->complete, 0, sizeof(v->complete));
+        v->n_complete = 0;
+        for (u8 i = 0; i < BOARD_SIZE; i++) _validator_count(v, i, board_data[i], 1);
+        dirty_units = (1u << N_UNITS) - 1;
+        v->valid    = 1;
+    } else {
+        // anything unlike the last result gets reflagged, digit changes move the counts
+        for (u8 i = 0; i < BOARD_SIZE; i++) {
+            u16 cell = board_data[i];
+            u16 last = v->cells[i];
+            if (cell == last) continue;
+
+            dirty_cells[i >> 6] |= u64(1) << (i & 63);
+            if (!((cell ^ last) & COUNTED_BITS)) continue;
+
+            _validator_count(v, i, last, 0);
+            _validator_count(v, i, cell, 1);
+            for (u8 k = 0; k < 3; k++) dirty_units |= 1u << CELL_UNITS(i)[k];
+        }
+    }
+
+    for (u8 u = 0; u < N_UNITS; u++) {
+        if (dirty_units & (1u << u)) _validator_unit(v, u);
+    }
+    u8 solved = v->n_complete == N_UNITS;
+
+    // solve flags touch every cell, otherwise only the changed units
+    if (solved || v->solved) dirty_units = (1u << N_UNITS) - 1;
+    for (u8 u = 0; u < N_UNITS; u++) {
+        if (!(dirty_units & (1u << u))) continue;
+        for (u8 k = 0; k < 9; k++) {
+            u8 i = UNIT_CELLS(u)[k];
+            dirty_cells[i >> 6] |= u64(1) << (i & 63);
+        }
+    }
+
+    u32 recount = 0;
+    for (u8 i = 0; i < BOARD_SIZE; i++) {
+        if (!((dirty_cells[i >> 6] >> (i & 63)) & 0x1)) continue;
+
+        u64 units = 0;
+        for (u8 k = 0; k < 3; k++) units |= v->errors[CELL_UNITS(i)[k]];
+
+        u16 cell = _flag_cell(board_data[i], _cell_error(board_data[i], units), solved);
+
+        // solving drops pencils, which the counts have to follow
+        if ((cell ^ board_data[i]) & COUNTED_BITS) {
+            _validator_count(v, i, board_data[i], 0);
+            _validator_count(v, i, cell,          1);
+            for (u8 k = 0; k < 3; k++) recount |= 1u << CELL_UNITS(i)[k];
+        }
+        board_data[i] = cell;
+        v->cells[i]   = cell;
+    }
+    for (u8 u = 0; u < N_UNITS; u++) {
+        if (recount & (1u << u)) _validator_unit(v, u);
+    }
+    v->solved = solved;
+
+#ifdef DEBUG_ENABLE
+    if (full_solved != solved || memcmp(full, board_data, sizeof(full))) {
+        printf("[Validate] incremental validation differs from validate_board\n");
+        for (u8 i = 0; i < BOARD_SIZE; i++) {
+            if (full[i] != board_data[i]) printf("  cell %2u  full 0x%04X  incremental 0x%04X\n", i, full[i], board_data[i]);
+        }
+    }
+#endif
+
+    return solved;
+}
+
+// -- Auto Candidates
+u8 _is_pencil(u16 cell) {
+    return (cell & (BOARD_FLAG_PENCIL | BOARD_FLAG_STATIC)) == BOARD_FLAG_PENCIL;
+}
+
+// digits a cell has entered, pencils don't count unless static
+u16 _placed(u16 cell) {
+    return cell & BOARD_ALL & ~(u16(0) - u16(_is_pencil(cell)));
+}
+
+u16 peer_digits(u16* board, u8 idx) {
+    u16 digits = 0;
+    for (u8 k = 0; k < N_PEERS; k++) digits |= _placed(board[CELL_PEERS(idx)[k]]);
+    return digits;
+}
+
+void fill_candidates(u16* board) {
+    for (u8 i = 0; i < BOARD_SIZE; i++) {
+        if (_placed(board[i])) continue;
+        board[i] = (board[i] & BOARD_FLAGS) | BOARD_FLAG_PENCIL | (BOARD_ALL & ~peer_digits(board, i));
+    }
+}
+
+void update_candidates(u16* board, u8 idx, u16 before) {
+    u16 was = _placed(before);
+    u16 now = _placed(board[idx]);
+
+    // placed digits leave the peers' pencils
+    u16 added = now & ~was;
+    if (added) {
+        for (u8 k = 0; k < N_PEERS; k++) {
+            u8 peer = CELL_PEERS(idx)[k];
+            if (_is_pencil(board[peer])) board[peer] &= ~added;
+        }
+    }
+
+    // cleared ones come back wherever no other placed peer still has them
+    u16 removed = was & ~now;
+    if (removed) {
+        if (!now) board[idx] = (board[idx] & BOARD_FLAGS) | BOARD_FLAG_PENCIL | (BOARD_ALL & ~peer_digits(board, idx));
+        for (u8 k = 0; k < N_PEERS; k++) {
+            u8 peer = CELL_PEERS(idx)[k];
+            if (_is_pencil(board[peer])) board[peer] |= removed & ~peer_digits(board, peer);
+        }
+    }
+}
+
+
+
+// -- Progressive Solver
+u8 set_pencils(u16* board, u8 clear) {
+    u8 statics = 0;
+    u16 mask = BOARD_FLAG_PENCIL | BOARD_ALL;
+
+    // set non-statics to full pencils
+    for (u16 idx = 0; idx < BOARD_SIZE; idx++) {
+        if (!(board[idx] & BOARD_FLAG_STATIC)) {
+            if (clear) {
+                board[idx] |= mask;
+            } else if (!(board[idx] & BOARD_ALL) || (board[idx] & BOARD_FLAG_PENCIL)) {
+                // set if there is only 1 bit set
+                board[idx] |= mask;
+            }
+        } else statics++;
+    }
+
+    return statics != 81;
+}
+
+// keeps what cell idx held before the step first wrote to it
+inline void _mark_change(ProgressChanges* changes, u16* board, u16 idx) {
+    if (!changes) return;
+    u64 bit = u64(1) << (idx & 63);
+    if (changes->cells[idx >> 6] & bit) return;
+    changes->cells[idx >> 6] |= bit;
+    changes->before[idx]      = board[idx];
+}
+
+// compares cells to remove options
+u8 _deduce_cell(u16* base, u16* cmp, u16* all_cache, u16* set_cache) {
+    bool cell_static = *cmp & BOARD_FLAG_STATIC;
+    bool cell_pencil = *cmp & BOARD_FLAG_PENCIL;
+
+    *all_cache |= *cmp; /* cache all elements *except* the base element */
+
+    if (cell_static || !cell_pencil) {
+        *set_cache |= *cmp; /* cache all _set_ elements *except* base element */
+
+        u16 tmp = *base;
+        *base &= ~(*cmp & BOARD_ALL);
+        if ((tmp & BOARD_ALL) != (*base & BOARD_ALL)) {
+            return PROGRESS_STATE_CHANGE;
+        }
+    }
+
+    return PROGRESS_DEFAULT;
+}
+
+// solidifies options
+u8 _ink_cell(u16* base, u16 all_cache) {
+    all_cache &= BOARD_ALL;
+
+    u16 check = *base & BOARD_ALL;
+    if (BIT_COUNT(check) == 1) {
+        // only 1 option left
+        *base &= ~u16(BOARD_FLAG_PENCIL);
+        return PROGRESS_SET_CELL;
+    }
+    
+    if (all_cache < BOARD_ALL) {
+        /*
+           0000 0001 1011 1111 :: cache :: no 7's in the square/row/col
+           0000 0000 1111 0000 :: board :: we can put our 7 down
+           
+           0000 0000 1011 0000 :: board & cache
+           0000 0000 0100 0000 :: board ^ (board & cache)
+        */
+        check = *base ^ (*base & all_cache);
+        if (check & BOARD_ALL) {
+            *base &= check | BOARD_FLAGS;
+            *base &= ~u16(BOARD_FLAG_PENCIL);
+            return PROGRESS_SET_CELL;
+        }
+    }
+
+    return PROGRESS_DEFAULT;
+}
+
+u8 _solve_square(u16* board, u16 base_idx, u16 base_x, u16 base_y, u8 square_rule, ProgressChanges* changes) {
+    #define R(i)   sq_cache[0+i]
+    #define C(i)   sq_cache[3+i]
+    u16 sq_cache[6]; // caches 3 rows + 3 cols
+    for (u8 i = 0; i < 6; i++) sq_cache[i] = 0;
+
+    // local square coords
+    const u8* sq = UNIT_CELLS(UNIT_BOX(board_tables.box[base_idx]));
+    u16 origin_x = board_tables.col[sq[0]];
+    u16 origin_y = board_tables.row[sq[0]];
+
+    u16 n[2];
+    n[0] = base_y - origin_y;
+    n[1] = base_x - origin_x;
+
+    u8 state_change = PROGRESS_DEFAULT;
+    _mark_change(changes, board, base_idx);
+
+    u8  result;
+    u16 all_cache = 0;
+    u16 set_cache = 0;
+
+    for (u16 cmp_y = 0; cmp_y < 3; cmp_y++) {
+        for (u16 cmp_x = 0; cmp_x < 3; cmp_x++) {
+            u16 cmp_idx = sq[cmp_y*3 + cmp_x];
+            if (cmp_idx == base_idx) continue;
+
+            result = _deduce_cell(&board[base_idx], &board[cmp_idx], &all_cache, &set_cache);
+            if (result == PROGRESS_STATE_CHANGE) state_change = result;
+
+            // cache element options
+            u16 pencil = (board[cmp_idx] & BOARD_FLAG_PENCIL) > 0;
+            u16 digits = pencil * (board[cmp_idx] & BOARD_ALL);
+            R(cmp_y) |= digits;
+            C(cmp_x) |= digits;
+        }
+    }
+    set_cache &= BOARD_ALL;
+
+    // cache base cell
+    u16 digits = board[base_idx] & BOARD_ALL;
+    R(n[0]) |= digits;
+    C(n[1]) |= digits;
+
+    u16 q;
+    u16 lower, upper;
+
+    /*
+        -- determine if this is a row or column application
+
+                                            9 9                            
+                                            v v                            
+                                           +-----+                         
+                   3 7 8            7, 8 > |3 * *| ---> 7, 8 --->          
+                   5 1 2    =>             |5 1 2|                         
+                   9 6 4             3*  > |* 6 4|                        3* to indicate lingering option 
+                                           +-----+                         
+           0000 0000 0011 1111 :: set
+
+           0000 0001 1100 0000 :: r1    0000 0000 1100 0000 :: q1 = r1 & ~(r2 | r3 | set)   -- Get pencil numbers exclusive to this row
+           0000 0000 0000 0000 :: r2    0000 0000 0000 0000 :: q2 = r2 & ~(r1 | r3 | set)          
+           0000 0001 0000 0100 :: r3    0000 0000 0000 0000 :: q3 = r3 & ~(r1 | r2 | set)          
+
+           0000 0001 0000 0100 :: c1    0000 0000 0000 0000 :: q1 = c1 & ~(c2 | c3 | set)   -- Get pencil numbers exclusive to this col
+           0000 0001 1100 0000 :: c2    0000 0000 0000 0000 :: q2 = c2 & ~(c1 | c3 | set)                                        
+           0000 0000 1100 0000 :: c3    0000 0000 0000 0000 :: q3 = c3 & ~(c1 | c2 | set)                                        
+    */
+
+    if (square_rule) {
+        // skip the current square
+        lower = origin_x;
+        upper = origin_x + 3;
+
+        // propagate removals through rows
+        q = R(n[0]) & ~(R(0)*u16(n[0]!=0) | 
+                        R(1)*u16(n[0]!=1) | 
+                        R(2)*u16(n[0]!=2) | set_cache);
+
+        for (u16 i = 0; i < 9 * u16(q>0); i++) {
+            if (i >= lower && i < upper) continue;
+            u16 idx = IDX(i, base_y);
+            if (!(board[idx] & BOARD_FLAG_PENCIL) || !(board[idx] & q)) continue;
+            _mark_change(changes, board, idx);
+            board[idx] &= ~q;
+        }
+    }
+
+    if (square_rule) {
+        // skip the current square
+        lower = origin_y;
+        upper = origin_y + 3;
+
+        // propagate removals through cols
+        q = C(n[1]) & ~(C(0)*u16(n[1]!=0) | 
+                        C(1)*u16(n[1]!=1) | 
+                        C(2)*u16(n[1]!=2) | set_cache);
+
+        for (u16 i = 0; i < 9 * u16(q>0); i++) {
+            if (i >= lower && i < upper) continue;
+            u16 idx = IDX(base_x, i);
+            if (!(board[idx] & BOARD_FLAG_PENCIL) || !(board[idx] & q)) continue;
+            _mark_change(changes, board, idx);
+            board[idx] &= ~q;
+        }
+    }
+
+    #undef R
+    #undef C
+
+    result = _ink_cell(&board[base_idx], all_cache);
+    if (result == PROGRESS_SET_CELL) state_change = result;
+    return state_change;
+}
+
+u8 _solve_row(u16* board, u16 base_idx, u16 base_y, ProgressChanges* changes) {
+    u8 state_change = PROGRESS_DEFAULT;
+    _mark_change(changes, board, base_idx);
+
+    u8  result;
+    u16 all_cache = 0;
+    u16 set_cache = 0;
+
+    // remove possible options from cell
+    for (u16 cmp_x = 0; cmp_x < 9; cmp_x++) {
+        u16 cmp_idx = IDX(cmp_x, base_y);
+        if (cmp_idx == base_idx) continue;
+        result = _deduce_cell(&board[base_idx], &board[cmp_idx], &all_cache, &set_cache);
+        if (result == PROGRESS_STATE_CHANGE) state_change = result;
+    }
+
+    // set cell if possible
+    result = _ink_cell(&board[base_idx], all_cache);
+    if (result == PROGRESS_SET_CELL) state_change = result;
+
+    // clear row
+    if (state_change == PROGRESS_SET_CELL) {
+        u16 digit = board[base_idx] & BOARD_ALL;
+        for (u16 i = 0; i < 9; i++) {
+            u16 idx = IDX(i, base_y);
+            if (!(board[idx] & BOARD_FLAG_PENCIL) || !(board[idx] & digit)) continue;
+            _mark_change(changes, board, idx);
+            board[idx] &= ~digit;
+        }
+        board[base_idx] |= digit;
+    }
+
+    return state_change;
+}
+
+u8 _solve_col(u16* board, u16 base_idx, u16 base_x, ProgressChanges* changes) {
+    u8 state_change = PROGRESS_DEFAULT;
+    _mark_change(changes, board, base_idx);
+
+    u8  result;
+    u16 all_cache = 0;
+    u16 set_cache = 0;
+
+    // remove possible options from cell
+    for (u16 cmp_y = 0; cmp_y < 9; cmp_y++) {
+        u16 cmp_idx = IDX(base_x, cmp_y);
+        if (cmp_idx == base_idx) continue;
+        result = _deduce_cell(&board[base_idx], &board[cmp_idx], &all_cache, &set_cache);
+        if (result == PROGRESS_STATE_CHANGE) state_change = result;
+    }
+
+    // set cell if possible
+    result = _ink_cell(&board[base_idx], all_cache);
+    if (result == PROGRESS_SET_CELL) state_change = result;
+
+    // clear col
+    if (state_change == PROGRESS_SET_CELL) {
+        u16 digit = board[base_idx] & BOARD_ALL;
+        for (u16 i = 0; i < 9; i++) {
+            u16 idx = IDX(base_x, i);
+            if (!(board[idx] & BOARD_FLAG_PENCIL) || !(board[idx] & digit)) continue;
+            _mark_change(changes, board, idx);
+            board[idx] &= ~digit;
+        }
+        board[base_idx] |= digit;
+    }
+
+    return state_change;
+}
+
+
+#ifdef STATS_ENABLE
+// candidates left in the non static cells
+u32 _count_candidates(u16* board) {
+    u32 count = 0;
+    for (u8 i = 0; i < BOARD_SIZE; i++) {
+        if (!(board[i] & BOARD_FLAG_STATIC)) count += BIT_COUNT(board[i]);
+    }
+    return count;
+}
+#endif
+
+// NOTE: this procedure is aesthetics > function
+u8 _make_progress(u16* board, u8 base_x, u8 base_y, u8 stage, u8 square_rule, ProgressChanges* changes, SolverStats* stats) {
+    // skip statics and already set cells
+    u16 base_idx = IDX(base_x, base_y);
+    {
+        bool cell_static = board[base_idx] & BOARD_FLAG_STATIC;
+        bool cell_pencil = board[base_idx] & BOARD_FLAG_PENCIL;
+        if (cell_static || !cell_pencil) return PROGRESS_INV_CELL;
+    }
+
+#ifdef STATS_ENABLE
+    u32 candidates = stats ? _count_candidates(board) : 0;
+#endif
+    STAT_BEGIN(stats, STAT_STAGE_PROGRESS);
+
+    u8 result = PROGRESS_DEFAULT;
+    if      (stage == 0) result = _solve_square(board, base_idx, base_x, base_y, square_rule, changes);
+    else if (stage == 1) result = _solve_row(board, base_idx, base_y, changes);
+    else if (stage == 2) result = _solve_col(board, base_idx, base_x, changes);
+
+    STAT_END(stats, STAT_STAGE_PROGRESS);
+#ifdef STATS_ENABLE
+    // stages line up with the square, row and col techniques
+    if (stats && stage < 3) {
+        stats->runs[STAT_TECH_SQUARE + stage]         += 1;
+        stats->eliminations[STAT_TECH_SQUARE + stage] += candidates - _count_candidates(board);
+        stats->placements[STAT_TECH_SQUARE + stage]   += result == PROGRESS_SET_CELL;
+    }
+#endif
+
+    return result;
+}
+
+u8 make_progress(u16* board, u8 base_x, u8 base_y, u8 stage, u8 square_rule, SolverStats* stats) {
+    return _make_progress(board, base_x, base_y, stage, square_rule, NULL, stats);
+}
+
+
+// -- Progress Queue
+#define QUEUE_BIT(i)            (u64(1) << ((i) & 63))
+#define QUEUE_ADD(m, i)         ((m)[(i) >> 6] |= QUEUE_BIT(i))
+#define QUEUE_DROP(m, i)        ((m)[(i) >> 6] &= ~QUEUE_BIT(i))
+
+// row and col steps cost under half of a square step, so they go first
+const u8 queue_order[3] = { 1, 2, 0 };
+
+// pencil cell i now holds cell, drops out of every mask if it isn't one anymore
+void _queue_track(ProgressQueue* q, u8 i, u16 before, u16 cell) {
+    QUEUE_DROP(q->counts[BIT_COUNT(before)], i);
+    if (_is_pencil(cell)) QUEUE_ADD(q->counts[BIT_COUNT(cell)], i);
+
+    u16 left = _is_pencil(cell) ? cell : 0;
+    u16 gone = before & ~left & BOARD_ALL;
+    while (gone) {
+        QUEUE_DROP(q->digits[BIT_DIGIT(gone & (0 - gone)) - 1], i);
+        gone &= gone - 1;
+    }
+
+    u16 placed = _placed(cell);
+    if (!placed) return;
+    for (u8 s = 0; s < 3; s++) QUEUE_DROP(q->queued[s], i);
+    for (u8 u = 0; u < 3; u++) q->set[CELL_UNITS(i)[u]] |= placed;
+}
+
+void queue_init(ProgressQueue* q, u16* board) {
+    memset(q->queued, 0, sizeof(q->queued));
+    memset(q->counts, 0, sizeof(q->counts));
+    memset(q->digits, 0, sizeof(q->digits));
+    memset(q->set,    0, sizeof(q->set));
+    q->cell  = 0xFF;
+    q->stage = 0;
+    q->calls = 0;
+    for (u8 i = 0; i < BOARD_SIZE; i++) {
+        u16 cell = board[i];
+        if (!_is_pencil(cell)) {
+            for (u8 u = 0; u < 3; u++) q->set[CELL_UNITS(i)[u]] |= _placed(cell);
+            continue;
+        }
+        for (u8 s = 0; s < 3; s++) QUEUE_ADD(q->queued[s], i);
+        QUEUE_ADD(q->counts[BIT_COUNT(cell)], i);
+        for (u8 d = 0; d < BOARD_DIM; d++) {
+            if (cell & (1 << d)) QUEUE_ADD(q->digits[d], i);
+        }
+    }
+}
+
+// cheapest stage first, then the fewest candidates, then the lowest cell
+u8 _queue_pop(ProgressQueue* q) {
+    for (u8 o = 0; o < 3; o++) {
+        u8 s = queue_order[o];
+        if (!(q->queued[s][0] | q->queued[s][1])) continue;
+        for (u8 n = 0; n <= BOARD_DIM; n++) {
+            for (u8 k = 0; k < 2; k++) {
+                u64 m = q->queued[s][k] & q->counts[n][k];
+                if (!m) continue;
+                u8 i = k*64 + mask_first(m);
+                QUEUE_DROP(q->queued[s], i);
+                q->stage = s;
+                return i;
+            }
+        }
+    }
+    return 0xFF;
+}
+
+// a stage on a cell only gets further when its box, row or col places one
+// of its digits, or loses one that then points at it: a digit left with a
+// single place in the unit, or, in a box, on a single line that the square
+// rule pushes it out of
+void _queue_unit(ProgressQueue* q, u8 unit, u8 stage, u16 placed, u16 lost) {
+    u64*       queued = q->queued[stage];
+    const u64* cells  = UNIT_MASK(unit);
+
+    while (placed) {
+        const u64* with = q->digits[BIT_DIGIT(placed & (0 - placed)) - 1];
+        queued[0] |= cells[0] & with[0];
+        queued[1] |= cells[1] & with[1];
+        placed &= placed - 1;
+    }
+
+    lost &= ~q->set[unit];
+    while (lost) {
+        const u64* with = q->digits[BIT_DIGIT(lost & (0 - lost)) - 1];
+        lost &= lost - 1;
+
+        u64 lo = cells[0] & with[0];
+        u64 hi = cells[1] & with[1];
+        if (!(lo | hi)) continue;
+
+        u8 first  = lo ? mask_first(lo) : 64 + mask_first(hi);
+        u8 single = lo ? !((lo & (lo - 1)) | hi) : !(hi & (hi - 1));
+        u8 line   = 0;
+        for (u8 u = 0; u < 2 && stage == 0 && !single && !line; u++) {
+            const u64* along = UNIT_MASK(CELL_UNITS(first)[u]);
+            line = !((lo & ~along[0]) | (hi & ~along[1]));
+        }
+        if (single || line) QUEUE_ADD(queued, first);
+    }
+}
+
+// only the cells the step wrote to, no board diff
+void _queue_changes(ProgressQueue* q, ProgressChanges* changes, u16* board) {
+    // masks first, so the units see the board after the whole step
+    for (u8 k = 0; k < 2; k++) {
+        u64 m = changes->cells[k];
+        while (m) {
+            u8 i = k*64 + mask_first(m);
+            m &= m - 1;
+            if (changes->before[i] != board[i]) _queue_track(q, i, changes->before[i], board[i]);
+        }
+    }
+
+    for (u8 k = 0; k < 2; k++) {
+        u64 m = changes->cells[k];
+        while (m) {
+            u8 i = k*64 + mask_first(m);
+            m &= m - 1;
+
+            u16 before = changes->before[i];
+            if (before == board[i]) continue;
+
+            // squeezed down to a single candidate by another cell's step
+            if (_is_pencil(board[i]) && BIT_COUNT(board[i]) == 1) QUEUE_ADD(q->queued[queue_order[0]], i);
+
+            u16 placed = _placed(board[i]) & ~_placed(before);
+            u16 lost   = before & ~board[i] & BOARD_ALL;
+
+            // the row feeds the row stage, the col the col stage, the box the square stage
+            const u8* units = CELL_UNITS(i);
+            _queue_unit(q, units[0], 1, placed, lost);
+            _queue_unit(q, units[1], 2, placed, lost);
+            _queue_unit(q, units[2], 0, placed, lost);
+        }
+    }
+}
+
+u8 queue_step(ProgressQueue* q, u16* board, SolverStats* stats) {
+    q->cell = _queue_pop(q);
+    if (q->cell == 0xFF) return PROGRESS_FIXPOINT;
+
+    ProgressChanges changes;
+    changes.cells[0] = 0;
+    changes.cells[1] = 0;
+
+    u8 x = board_tables.col[q->cell];
+    u8 y = board_tables.row[q->cell];
+    u8 status = _make_progress(board, x, y, q->stage, 1, &changes, stats);
+    q->calls++;
+
+    _queue_changes(q, &changes, board);
+    return status;
+}
+
+
+/*
+FIXME
+implement tree search for something like this,
+
+300200000
+000107000
+706030500
+070009080
+900020004
+010800050
+009040301
+000702000
+000008006
+*/
+
+
+
+// -- Fast Solver
+#define CACHE_REGION() {\
+    u8 flag = 0;\
+    flag |= (board[indices[n]] & BOARD_FLAG_STATIC) != 0;\
+    flag |= (board[indices[n]] & BOARD_FLAG_PENCIL) == 0;\
+    if (flag) {\
+        statics |= board[indices[n]];\
+    }\
+    \
+    /* cache region */\
+    for (u8 i = 0; i < 9; i++) {\
+        if (!n) caches[i] = 0;\
+        if (n == i) continue;\
+        caches[i] |= board[indices[n]];\
+    }\
+}
+
+
+#define UPDATE_REGION() {\
+    statics &= BOARD_ALL;\
+    while (statics < BOARD_ALL) {\
+        u8 set = 0;\
+        for (u8 x = 0; x < 9; x++) {\
+            if (board[indices[x]] & BOARD_FLAG_PENCIL) {\
+                /* update pencil options */ \
+                STAT_TECH(stats, eliminations, STAT_TECH_REGION, BIT_COUNT(board[indices[x]] & statics));\
+                board[indices[x]] &= ~statics;\
+                \
+                /* ink */ \
+                u16 check = board[indices[x]] & BOARD_ALL;\
+                if (BIT_COUNT(check) == 1) {\
+                    board[indices[x]] &= ~u16(BOARD_FLAG_PENCIL);\
+                    statics |= check;\
+                    set = 1;\
+                    STAT_TECH(stats, placements, STAT_TECH_REGION, 1);\
+                } else {\
+                    u16 changed = check ^ (check & caches[x] & BOARD_ALL);\
+                    if (changed) {\
+                        STAT_TECH(stats, eliminations, STAT_TECH_REGION, BIT_COUNT(check & ~changed));\
+                        STAT_TECH(stats, placements,   STAT_TECH_REGION, 1);\
+                        board[indices[x]] &= changed | BOARD_FLAGS;\
+                        board[indices[x]] &= ~u16(BOARD_FLAG_PENCIL);\
+                        statics |= changed;\
+                        set = 1;\
+                    }\
+                }\
+            }\
+        }\
+        if (!set) break;\
+    }\
+}
+
+
+u8 fast_solve(u16* board, SolverStats* stats) {
+    STAT_BEGIN(stats, STAT_STAGE_FAST);
+    u8  solved = 0;
+
+    u16 indices[9];
+    u16 caches[9];
+    u16 statics;
+
+    // rows, then squares, then cols -- TODO should add the square rule here
+    const u8 order[N_UNITS] = {
+        UNIT_ROW(0), UNIT_ROW(1), UNIT_ROW(2), UNIT_ROW(3), UNIT_ROW(4), UNIT_ROW(5), UNIT_ROW(6), UNIT_ROW(7), UNIT_ROW(8),
+        UNIT_BOX(0), UNIT_BOX(1), UNIT_BOX(2), UNIT_BOX(3), UNIT_BOX(4), UNIT_BOX(5), UNIT_BOX(6), UNIT_BOX(7), UNIT_BOX(8),
+        UNIT_COL(0), UNIT_COL(1), UNIT_COL(2), UNIT_COL(3), UNIT_COL(4), UNIT_COL(5), UNIT_COL(6), UNIT_COL(7), UNIT_COL(8),
+    };
+
+    for (u8 u = 0; u < N_UNITS; u++) {
+        statics = 0;
+
+        // grab statics
+        for (u8 n = 0; n < 9; n++) {
+            indices[n] = UNIT_CELLS(order[u])[n];
+            CACHE_REGION();
+        }
+
+        UPDATE_REGION();
+        if (statics == BOARD_ALL) solved++;
+        STAT_TECH(stats, runs, STAT_TECH_REGION, 1);
+    }
+    STAT_END(stats, STAT_STAGE_FAST);
+
+    // solved [rows + cols + squares]
+    return solved == 27;
+}
+
+
+
+// -- Generation
+/*
+    random fill -- the three diagonal boxes don't see each other, so they
+    start as shuffled digit rows. each of the other 54 cells takes a random
+    digit among those its row, col and box still allow, the cell with the
+    fewest of them first, backtracking when a cell runs out.
+*/
+u16 _random_bit(u16 bits, Rng* rng) {
+    u8 k = u8(rng_below(rng, BIT_COUNT(bits)));
+    while (k--) bits &= bits - 1;
+    return bits & (~bits + 1);
+}
+
+void generate_grid(u8* grid, Rng* rng) {
+    u16 rows[9]  = {0};
+    u16 cols[9]  = {0};
+    u16 boxes[9] = {0};
+
+    #define ALLOWED(i) (BOARD_ALL & ~(rows[board_tables.row[i]] | cols[board_tables.col[i]] | boxes[board_tables.box[i]]))
+    #define TOGGLE(i, bit) {\
+        rows[board_tables.row[i]]  ^= bit;\
+        cols[board_tables.col[i]]  ^= bit;\
+        boxes[board_tables.box[i]] ^= bit;\
+    }
+
+    // cells [0, n) of order are filled, the rest are still open
+    u8 order[BOARD_SIZE];
+    u8 n_order = 0;
+    for (u8 i = 0; i < BOARD_SIZE; i++) {
+        u8 b = board_tables.box[i];
+        if (b == 0 || b == 4 || b == 8) continue;
+        order[n_order++] = i;
+    }
+
+    for (u8 b = 0; b < 9; b += 4) {
+        u16 left = BOARD_ALL;
+        for (u8 k = 0; k < BOARD_DIM; k++) {
+            u8  i   = UNIT_CELLS(UNIT_BOX(b))[k];
+            u16 bit = _random_bit(left, rng);
+            left &= ~bit;
+            grid[i] = BIT_DIGIT(bit);
+            TOGGLE(i, bit);
+        }
+    }
+
+    // untried digits and the digit placed, per position
+    u16 left[BOARD_SIZE];
+    u16 placed[BOARD_SIZE];
+
+    u8 n     = 0;
+    u8 enter = 1;
+    while (n < n_order) {
+        if (enter) {
+            // fewest allowed digits next
+            u8 best       = n;
+            u8 best_count = 0xFF;
+            for (u8 k = n; k < n_order; k++) {
+                u8 count = BIT_COUNT(ALLOWED(order[k]));
+                if (count < best_count) {
+                    best       = k;
+                    best_count = count;
+                    if (count <= 1) break;
+                }
+            }
+            u8 tmp      = order[n];
+            order[n]    = order[best];
+            order[best] = tmp;
+            left[n]     = ALLOWED(order[n]);
+        }
+
+        if (!left[n]) {
+            // out of digits, take back the previous cell and try its next one
+            if (!n) break;
+            n--;
+            TOGGLE(order[n], placed[n]);
+            enter = 0;
+            continue;
+        }
+
+        u16 bit = _random_bit(left[n], rng);
+        left[n]  &= ~bit;
+        placed[n] = bit;
+        grid[order[n]] = BIT_DIGIT(bit);
+        TOGGLE(order[n], bit);
+        n++;
+        enter = 1;
+    }
+
+    #undef ALLOWED
+    #undef TOGGLE
+}
+
+// a full grid of statics, freshly filled and moved by a random element of the group
+void _generate_solution(u16* board, Rng* rng) {
+    u8 grid[BOARD_SIZE];
+    u8 moved[BOARD_SIZE];
+    generate_grid(grid, rng);
+
+    Transform t;
+    random_transform(&t, rng);
+    apply_transform(&t, grid, moved);
+    for (u8 i = 0; i < BOARD_SIZE; i++) board[i] = BOARD_FLAG_STATIC | (1 << (moved[i] - 1));
+}
+
+void _generate_shuffle(u8* order, u8 n, Rng* rng) {
+    for (u8 i = n - 1; i > 0; i--) {
+        u8 j     = u8(rng_below(rng, i + 1));
+        u8 tmp   = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+}
+
+// the small unavoidable sets of a full board of statics, with every cell a clue
+void _generate_sets(const u16* solution, Unavoidables* ua, u64* clues) {
+    u8 grid[BOARD_SIZE];
+    for (u8 i = 0; i < BOARD_SIZE; i++) grid[i] = BIT_DIGIT(solution[i]);
+    ua_find(grid, ua, GENERATE_SET_DIGITS);
+
+    clues[0] = ~0ull;
+    clues[1] = (1ull << (BOARD_SIZE - 64)) - 1;
+}
+
+// a clue the dig kept early can turn redundant once later ones are out. drop
+// them, the whole orbit of one at a time, as long as the rating stays inside
+// the band (or at least where it was, when the budget ran out)
+u32 _generate_minimal(u16* board, DifficultyRange range, u8 symmetry, u32 score, LogicPipeline* rater, SolverStats* stats) {
+    u32 floor = (score < range.lo) ? score : range.lo;
+
+    u8 redundant[BOARD_SIZE];
+    u8 n_redundant = check_minimal(board, NULL, redundant, 0, NULL, stats);
+    while (n_redundant && n_redundant != MINIMAL_NOT_UNIQUE) {
+        u8 dropped = 0;
+        for (u8 i = 0; i < n_redundant && !dropped; i++) {
+            u8  orbit[SYMMETRY_MAX_ORBIT];
+            u16 kept[SYMMETRY_MAX_ORBIT];
+            u8  n = 0;
+            u8  j = redundant[i];
+            do {
+                orbit[n]   = j;
+                kept[n++]  = board[j];
+                board[j]   = BOARD_EMPTY;
+                j = symmetry_image(symmetry, j);
+            } while (j != redundant[i]);
+
+            // rated means the techniques finish it, so it's still unique
+            u32 rated = logic_rate(board, rater, stats);
+            if (rated != LOGIC_UNRATED && rated >= floor && rated < range.hi) {
+                score   = rated;
+                dropped = 1;
+            } else {
+                for (u8 k = 0; k < n; k++) board[orbit[k]] = kept[k];
+            }
+        }
+        if (!dropped) break;
+
+        n_redundant = check_minimal(board, NULL, redundant, 0, NULL, stats);
+    }
+    return score;
+}
+
+u32 generate_puzzle(u16* board, DifficultyRange range, u64 budget_us, u8 symmetry, Rng* rng, SolverStats* stats) {
+    LogicPipeline rater;
+    logic_init(&rater, 1);
+
+    const SymmetryOrbits* orbits = &symmetry_orbits[symmetry];
+
+    u64 start      = stats_ticks();
+    u32 best_miss  = 0xFFFFFFFF;
+    u32 best_score = 0;
+    u16 best[BOARD_SIZE];
+
+    u16 solution[BOARD_SIZE];
+    u8  order[BOARD_SIZE];
+    for (u8 i = 0; i < orbits->n_orbits; i++) order[i] = i;
+
+    Unavoidables ua;
+    u64          clues[2];
+
+    for (u32 grids = 1;; grids++) {
+        _generate_solution(solution, rng);
+        memcpy(board, solution, sizeof(solution));
+        _generate_sets(solution, &ua, clues);
+
+        // orbits in the order they were dug out
+        u8  dug[BOARD_SIZE];
+        u8  n_dug = 0;
+        u32 score = 0;
+
+        for (u32 round = 0; round < GENERATE_ROUNDS; round++) {
+            // a removal stays out if the stages still finish and the
+            // score stays under the band, so easy digs stop early
+            _generate_shuffle(order, orbits->n_orbits, rng);
+            for (u8 n = 0; n < orbits->n_orbits; n++) {
+                u8        o     = order[n];
+                const u8* cells = orbits->cells[o];
+                if (board[cells[0]] == BOARD_EMPTY) continue;
+
+                // a set left without a clue means a second solution, no need to rate
+                u64 taken[2] = {0, 0};
+                for (u8 k = 0; k < orbits->size[o]; k++) taken[cells[k] >> 6] |= 1ull << (cells[k] & 63);
+                clues[0] &= ~taken[0];
+                clues[1] &= ~taken[1];
+
+                u32 rated = LOGIC_UNRATED;
+                if (ua_hit_all(&ua, clues)) {
+                    for (u8 k = 0; k < orbits->size[o]; k++) board[cells[k]] = BOARD_EMPTY;
+                    rated = logic_rate(board, &rater, stats);
+                }
+                if (rated == LOGIC_UNRATED || rated >= range.hi) {
+                    for (u8 k = 0; k < orbits->size[o]; k++) board[cells[k]] = solution[cells[k]];
+                    clues[0] |= taken[0];
+                    clues[1] |= taken[1];
+                    continue;
+                }
+                dug[n_dug++] = o;
+                score = rated;
+            }
+
+            u32 miss = (score < range.lo) ? range.lo - score : 0;
+            if (miss < best_miss) {
+                best_miss  = miss;
+                best_score = score;
+                memcpy(best, board, sizeof(best));
+            }
+            if (!miss) return _generate_minimal(board, range, symmetry, score, &rater, stats);
+            u8 out = (budget_us == GENERATE_UNTIMED)
+                   ? grids >= GENERATE_UNTIMED_GRIDS && round == GENERATE_ROUNDS - 1
+                   : stats_ticks_to_ns(stats_ticks() - start) / 1000 >= budget_us;
+            if (out) {
+                memcpy(board, best, sizeof(best));
+                return _generate_minimal(board, range, symmetry, best_score, &rater, stats);
+            }
+
+            // still too easy, the last removals boxed it in. put them
+            // back and dig around them in a different order
+            for (u8 restored = 0; restored < GENERATE_BACKTRACK && n_dug;) {
+                u8 o = dug[--n_dug];
+                for (u8 k = 0; k < orbits->size[o]; k++) {
+                    u8 idx = orbits->cells[o][k];
+                    board[idx] = solution[idx];
+                    clues[idx >> 6] |= 1ull << (idx & 63);
+                }
+                restored += orbits->size[o];
+            }
+            score = logic_rate(board, &rater, stats);
+        }
+    }
+}
+
+void generate_unique(u16* board, SolverContext* ctx, Rng* rng) {
+    _generate_solution(board, rng);
+
+    u8 order[BOARD_SIZE];
+    for (u8 i = 0; i < BOARD_SIZE; i++) order[i] = i;
+    _generate_shuffle(order, BOARD_SIZE, rng);
+
+    // a clue that can't go now can't go later either, fewer clues only
+    // mean more solutions, so one pass leaves a minimal puzzle
+    for (u8 n = 0; n < BOARD_SIZE; n++) {
+        u8  idx  = order[n];
+        u16 clue = board[idx];
+        board[idx] = BOARD_EMPTY;
+
+        // unique iff no solution puts another digit here
+        solver_load(ctx, board);
+        solver_set(ctx, idx, BOARD_ALL & ~clue);
+        if (solver_count(ctx, 1, NULL)) board[idx] = clue;
+    }
+}
+
+
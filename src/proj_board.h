@@ -0,0 +1,411 @@
+#ifndef PROJ_BOARD_H
+#define PROJ_BOARD_H
+
+// local
+#include "proj_types.h"
+#include "proj_stats.h"
+#include "proj_pool.h"
+#include "proj_rand.h"
+
+// system
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+
+
+#define BOARD_EMPTY        0x0000
+#define BOARD_1            0x0001
+#define BOARD_2            0x0002
+#define BOARD_3            0x0004
+#define BOARD_4            0x0008
+#define BOARD_5            0x0010
+#define BOARD_6            0x0020
+#define BOARD_7            0x0040
+#define BOARD_8            0x0080
+#define BOARD_9            0x0100
+#define BOARD_ALL          0x01FF
+
+#define BOARD_FLAG_PENCIL  0x8000
+#define BOARD_FLAG_ERROR   0x4000
+#define BOARD_FLAG_STATIC  0x2000
+#define BOARD_FLAG_CURSOR  0x1000
+#define BOARD_FLAG_HOVER   0x0800
+#define BOARD_FLAG_SOLVE   0x0400
+#define BOARD_FLAG_AI      0x0200
+#define BOARD_FLAGS        0xFE00
+
+// solver layout, 81 packed cells
+#define BOARD_DIM        9
+#define BOARD_SIZE       (BOARD_DIM * BOARD_DIM)
+#define IDX(x,y)         ((u16(y)*BOARD_DIM) + (x))
+
+// render layout, the board texture is 16x16 -- only used at the GL upload
+#define RENDER_DIM       16
+#define RENDER_SIZE      (RENDER_DIM * RENDER_DIM)
+#define RENDER_IDX(x,y)  ((u16(y)*RENDER_DIM) + (x))
+
+#define N_UNITS          27
+#define N_PEERS          20
+
+#define UNIT_ROW(y)      (y)
+#define UNIT_COL(x)      (9  + (x))
+#define UNIT_BOX(b)      (18 + (b))
+
+
+/*
+    lookup tables for the 81 cell layout, built at compile time
+
+    units      :: rows [0,9), cols [9,18), boxes [18,27), 9 cells each
+    cell_units :: row, col, box unit of a cell
+    unit_masks :: the cells of a unit, cell i is bit i & 63 of [i >> 6]
+    peers      :: the 20 cells sharing a unit with a cell
+    digit      :: single bit mask -> digit [1,9], 0 if not exactly one bit
+    bit_count  :: popcount of a 9 bit mask
+    bit_first  :: de bruijn product of a single bit u64 -> its index
+*/
+#define BIT_DEBRUIJN    0x03F79D71B4CB0A89ull
+
+struct BoardTables {
+    u8 row[BOARD_SIZE];
+    u8 col[BOARD_SIZE];
+    u8 box[BOARD_SIZE];
+    u8 units[N_UNITS][9];
+    u8 cell_units[BOARD_SIZE][3];
+    u64 unit_masks[N_UNITS][2];
+    u8 peers[BOARD_SIZE][N_PEERS];
+    u8 digit[BOARD_ALL + 1];
+    u8 bit_count[BOARD_ALL + 1];
+    u8 bit_first[64];
+};
+
+constexpr BoardTables build_board_tables() {
+    BoardTables t = {};
+
+    for (u32 i = 0; i < BOARD_SIZE; i++) {
+        t.row[i] = i / 9;
+        t.col[i] = i % 9;
+        t.box[i] = (i / 27) * 3 + (i % 9) / 3;
+    }
+
+    for (u32 u = 0; u < 9; u++) {
+        for (u32 k = 0; k < 9; k++) {
+            t.units[UNIT_ROW(u)][k] = u*9 + k;
+            t.units[UNIT_COL(u)][k] = k*9 + u;
+            t.units[UNIT_BOX(u)][k] = ((u/3)*3 + k/3)*9 + (u%3)*3 + (k%3);
+        }
+    }
+
+    for (u32 u = 0; u < N_UNITS; u++) {
+        for (u32 k = 0; k < 9; k++) {
+            u32 i = t.units[u][k];
+            t.unit_masks[u][i >> 6] |= u64(1) << (i & 63);
+        }
+    }
+
+    for (u32 i = 0; i < BOARD_SIZE; i++) {
+        t.cell_units[i][0] = UNIT_ROW(t.row[i]);
+        t.cell_units[i][1] = UNIT_COL(t.col[i]);
+        t.cell_units[i][2] = UNIT_BOX(t.box[i]);
+
+        u32 n = 0;
+        for (u32 j = 0; j < BOARD_SIZE; j++) {
+            if (i == j) continue;
+            if (t.row[i] == t.row[j] || t.col[i] == t.col[j] || t.box[i] == t.box[j]) {
+                t.peers[i][n] = j;
+                n++;
+            }
+        }
+    }
+
+    for (u32 m = 0; m <= BOARD_ALL; m++) {
+        u32 count = 0;
+        u32 first = 0;
+        for (u32 d = 0; d < 9; d++) {
+            if ((m >> d) & 0x1) {
+                if (!count) first = d + 1;
+                count++;
+            }
+        }
+        t.bit_count[m] = count;
+        t.digit[m]     = (count == 1) ? first : 0;
+    }
+
+    for (u32 i = 0; i < 64; i++) t.bit_first[((u64(1) << i) * BIT_DEBRUIJN) >> 58] = i;
+
+    return t;
+}
+
+constexpr BoardTables board_tables = build_board_tables();
+
+#define CELL_PEERS(i)     (board_tables.peers[i])
+#define CELL_UNITS(i)     (board_tables.cell_units[i])
+#define UNIT_CELLS(u)     (board_tables.units[u])
+#define UNIT_MASK(u)      (board_tables.unit_masks[u])
+#define BIT_DIGIT(m)      (board_tables.digit[(m) & BOARD_ALL])
+#define BIT_COUNT(m)      (board_tables.bit_count[(m) & BOARD_ALL])
+
+// no popcount or bit scan intrinsics, the masks are short
+inline u8 mask_count(u64 m) {
+    m = m - ((m >> 1) & 0x5555555555555555ull);
+    m = (m & 0x3333333333333333ull) + ((m >> 2) & 0x3333333333333333ull);
+    m = (m + (m >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return u8((m * 0x0101010101010101ull) >> 56);
+}
+
+// lowest set bit of a non zero mask
+inline u8 mask_first(u64 m) {
+    return board_tables.bit_first[((m & (0 - m)) * BIT_DEBRUIJN) >> 58];
+}
+
+
+// layout conversion
+void board_to_render(u16* board, u16* render);
+void render_to_board(u16* render, u16* board);
+
+
+// validation
+struct BoardCheck {
+    u64 errors[2];      // cell i is bit i & 63 of errors[i >> 6]
+    u8  solved;
+};
+
+#define CHECK_ERROR(c, i)   (((c)->errors[(i) >> 6] >> ((i) & 63)) & 0x1)
+
+void check_board(u16* board_data, BoardCheck* out);     // leaves the board alone
+u8   validate_board(u16* board_data);                   // sets error and solve flags, the errors of check_board
+u8   validate_board_units(u16* board_data);             // unit by unit, the reference for validate_board
+
+/*
+    incremental validation
+
+    keeps the digit counts of every unit for the board it last validated.
+    a call diffs the board against that result, moves the counts of only
+    the units whose cells changed digits, and reflags only their cells plus
+    any cell whose flags changed since. same flags and result as
+    validate_board, which DEBUG_ENABLE builds cross-check on every call.
+*/
+struct BoardValidator {
+    u16 cells[BOARD_SIZE];              // the board as last validated
+    u32 planes[N_UNITS][4];             // bit-sliced count of cells holding each any, entered, static digit
+    u64 errors[N_UNITS];                // error digits per kind of cell
+    u8  complete[N_UNITS];              // every digit held exactly once
+    u8  n_complete = 0;
+    u8  solved     = 0;
+    u8  valid      = 0;                 // counts match cells
+};
+
+void validator_reset(BoardValidator* v);                // next call counts from scratch
+u8   validate_incremental(BoardValidator* v, u16* board_data);
+
+
+/*
+    auto candidates
+
+    keeps the pencils of unplaced cells in step with the placed digits one
+    edit at a time, without a solver pass: placing a digit drops it from
+    the pencils of the cell's 20 peers, clearing it gives it back to each
+    peer (and the cell) that no other placed peer still rules it out for.
+*/
+u16  peer_digits(u16* board, u8 idx);                   // digits placed in the 20 peers
+void fill_candidates(u16* board);                       // every unplaced cell from scratch
+void update_candidates(u16* board, u8 idx, u16 before); // after board[idx] changed from before
+
+
+// progressive solver
+#define PROGRESS_DEFAULT        0   // no state change
+#define PROGRESS_STATE_CHANGE   1   // state change
+#define PROGRESS_INV_CELL       2   // invalid cell
+#define PROGRESS_SET_CELL       3   // cell solved
+#define PROGRESS_DEBUG          4   // exit
+#define PROGRESS_FIXPOINT       5   // nothing left to try
+
+// the cells a step wrote to, and what they held before it
+struct ProgressChanges {
+    u64 cells[2];               // cell i is bit i & 63 of [i >> 6]
+    u16 before[BOARD_SIZE];     // only set for the cells in the mask
+};
+
+u8 set_pencils(u16* board, u8 clear);
+u8 _solve_square(u16* board, u16 base_idx, u16 base_x, u16 base_y, u8 square_rule, ProgressChanges* changes);
+u8 _solve_row(u16* board, u16 base_idx, u16 base_y, ProgressChanges* changes);
+u8 _solve_col(u16* board, u16 base_idx, u16 base_x, ProgressChanges* changes);
+u8 make_progress(u16* board, u8 base_x, u8 base_y, u8 stage, u8 square_rule, SolverStats* stats);
+
+/*
+    progress worklist
+
+    instead of sweeping every cell and stage over and over, a cell is queued
+    for a stage only when the unit that stage reads (box, row or col)
+    places one of its digits, or loses a digit that's left pointing at it.
+    row and col steps go before square steps, which cost twice as much,
+    and within a stage the cell with the fewest candidates goes first. the progressive solve is at its fixpoint as soon as every
+    queue runs empty.
+
+    a step only looks at the cells it changed, and the queue keeps the
+    pencil cells as masks by candidate count and by digit, so neither
+    queueing nor picking the next cell scans the board. a stage's bucket
+    of n candidates is queued[stage] & counts[n].
+*/
+struct ProgressQueue {
+    u64 queued[3][2];                   // per stage, cell i is bit i & 63 of [i >> 6]
+    u64 counts[BOARD_DIM + 1][2];       // pencil cells by candidate count
+    u64 digits[BOARD_DIM][2];           // pencil cells with digit d + 1 left
+    u16 set[N_UNITS];                   // digits placed in each unit
+    u8  cell  = 0xFF;                   // cell of the last step, 0xFF at the fixpoint
+    u8  stage = 0;                      // stage of the last step
+    u32 calls = 0;                      // make_progress calls so far
+};
+
+void queue_init(ProgressQueue* q, u16* board);                   // every pencil cell
+u8   queue_step(ProgressQueue* q, u16* board, SolverStats* stats);  // one make_progress call, on q->cell after it returns
+
+
+// fast solver
+u8 fast_solve(u16* board, SolverStats* stats);
+
+
+// generation
+#define OUTPUT_BOARD() {\
+    for (u32 y = 0; y < 9; y++) {\
+        for (u32 x = 0; x < 9; x++) {\
+            u16 val = board[IDX(x,y)];\
+            if (val & BOARD_FLAG_PENCIL) { printf("0 "); continue; }\
+            printf("%u ", BIT_DIGIT(val));\
+        }\
+        printf("\n");\
+    }\
+    printf("\n");\
+}
+
+// a random complete grid, digits 1-9
+void generate_grid(u8* grid, Rng* rng);
+
+/*
+    target difficulty
+
+    a difficulty is a band [lo, hi) of logic_rate scores. clues are dug
+    out of a fresh grid as long as the stages still finish the puzzle and
+    the score stays under hi. a dig that ends below lo puts its last
+    GENERATE_BACKTRACK clues back and digs on in a new order, and after
+    GENERATE_ROUNDS of those it starts over from a new grid. out of budget
+    it settles for the closest puzzle so far. the clock makes that depend
+    on the machine, so an untimed dig counts grids instead and only the
+    seed decides the puzzle.
+
+    the small unavoidable sets of each new grid are found up front, a
+    removal that leaves one of them without a clue can't be unique and is
+    turned down without rating it.
+*/
+#define DIFFICULTY_EASY         0   // naked singles
+#define DIFFICULTY_MEDIUM       1   // hidden singles
+#define DIFFICULTY_HARD         2   // pointing and claiming
+#define DIFFICULTY_EXPERT       3   // naked subsets
+
+#define N_DIFFICULTIES          4
+
+#define GENERATE_BACKTRACK      12
+#define GENERATE_ROUNDS         16
+#define GENERATE_BUDGET_US      250000
+#define GENERATE_UNTIMED        0       // budget_us, give up after GENERATE_UNTIMED_GRIDS instead
+#define GENERATE_UNTIMED_GRIDS  32
+#define GENERATE_SET_DIGITS     2       // unavoidable sets of 2 digit subsets screen removals
+
+struct DifficultyRange {
+    u32 lo;
+    u32 hi;
+};
+
+constexpr DifficultyRange difficulty_ranges[N_DIFFICULTIES] = {
+    {0,  15},
+    {15, 30},
+    {30, 50},
+    {50, 0xFFFFFFFF},
+};
+
+constexpr const char* difficulty_names[N_DIFFICULTIES] = {"easy", "medium", "hard", "expert"};
+
+/*
+    clue symmetry
+
+    the givens can be kept symmetric by digging whole orbits of cells under
+    the symmetry instead of single cells, so a removal takes up to 4 clues
+    at once and is rated once. the orbits are built at compile time, an
+    orbit is listed once, under its lowest cell.
+*/
+#define SYMMETRY_NONE           0
+#define SYMMETRY_ROTATE_180     1
+#define SYMMETRY_MIRROR_X       2   // left to right
+#define SYMMETRY_MIRROR_Y       3   // top to bottom
+#define SYMMETRY_DIAGONAL       4   // across the main diagonal
+#define SYMMETRY_ROTATE_90      5
+
+#define N_SYMMETRIES            6
+#define SYMMETRY_MAX_ORBIT      4
+
+struct SymmetryOrbits {
+    u8 n_orbits;
+    u8 size[BOARD_SIZE];
+    u8 cells[BOARD_SIZE][SYMMETRY_MAX_ORBIT];
+};
+
+constexpr u8 symmetry_image(u8 symmetry, u8 idx) {
+    u8 x = idx % 9;
+    u8 y = idx / 9;
+    switch (symmetry) {
+        case SYMMETRY_ROTATE_180: return IDX(8 - x, 8 - y);
+        case SYMMETRY_MIRROR_X:   return IDX(8 - x, y);
+        case SYMMETRY_MIRROR_Y:   return IDX(x, 8 - y);
+        case SYMMETRY_DIAGONAL:   return IDX(y, x);
+        case SYMMETRY_ROTATE_90:  return IDX(8 - y, x);
+    }
+    return idx;
+}
+
+constexpr SymmetryOrbits build_symmetry_orbits(u8 symmetry) {
+    SymmetryOrbits t = {};
+
+    for (u8 i = 0; i < BOARD_SIZE; i++) {
+        // listed under its lowest cell, the other cells have come first
+        u8 lowest = 1;
+        for (u8 j = symmetry_image(symmetry, i); j != i; j = symmetry_image(symmetry, j)) {
+            if (j < i) lowest = 0;
+        }
+        if (!lowest) continue;
+
+        u8 o = t.n_orbits++;
+        u8 j = i;
+        do {
+            t.cells[o][t.size[o]++] = j;
+            j = symmetry_image(symmetry, j);
+        } while (j != i);
+    }
+    return t;
+}
+
+constexpr SymmetryOrbits symmetry_orbits[N_SYMMETRIES] = {
+    build_symmetry_orbits(SYMMETRY_NONE),
+    build_symmetry_orbits(SYMMETRY_ROTATE_180),
+    build_symmetry_orbits(SYMMETRY_MIRROR_X),
+    build_symmetry_orbits(SYMMETRY_MIRROR_Y),
+    build_symmetry_orbits(SYMMETRY_DIAGONAL),
+    build_symmetry_orbits(SYMMETRY_ROTATE_90),
+};
+
+constexpr const char* symmetry_names[N_SYMMETRIES] = {"none", "rotate 180", "mirror x", "mirror y", "diagonal", "rotate 90"};
+
+// the score of the puzzle left on the board, in range unless the budget ran out.
+// the givens are symmetric under symmetry. every choice is drawn from rng, so a
+// seed and the same arguments dig the same puzzle, unless the clock cuts it
+// short. a budget of GENERATE_UNTIMED stops after a number of grids instead.
+// a last pass drops the redundant clues check_minimal finds, whole orbits,
+// while the score stays in range. the clues left over are the ones the
+// techniques can't do without, or that would push the score out of the band
+u32  generate_puzzle(u16* board, DifficultyRange range, u64 budget_us, u8 symmetry, Rng* rng, SolverStats* stats);
+
+// digs out clues while the solution stays unique, any technique may be
+// needed. the result is minimal. ctx is reused for every check
+struct SolverContext;
+void generate_unique(u16* board, SolverContext* ctx, Rng* rng);
+
+#endif
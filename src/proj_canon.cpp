@@ -0,0 +1,352 @@
+#include "proj_canon.h"
+
+
+// -- Transforms
+void identity_transform(Transform* t) {
+    for (u8 i = 0; i < BOARD_SIZE; i++) t->cells[i] = i;
+    for (u8 d = 0; d < 10; d++) t->digits[d] = d;
+}
+
+void apply_transform(Transform* t, u8* in, u8* out) {
+    for (u8 i = 0; i < BOARD_SIZE; i++) {
+        out[i] = t->digits[in[t->cells[i]]];
+    }
+}
+
+void compose_transform(Transform* a, Transform* b, Transform* out) {
+    // a(b(x))[i] = a.digits[b.digits[x[b.cells[a.cells[i]]]]]
+    Transform tmp;
+    for (u8 i = 0; i < BOARD_SIZE; i++) tmp.cells[i] = b->cells[a->cells[i]];
+    for (u8 d = 0; d < 10; d++) tmp.digits[d] = a->digits[b->digits[d]];
+    *out = tmp;
+}
+
+void random_transform(Transform* t, Rng* rng) {
+    // rows and cols both take one of the band / stack preserving orders
+    const u8* rows = col_perms.cols[rng_below(rng, N_COL_PERMS)];
+    const u8* cols = col_perms.cols[rng_below(rng, N_COL_PERMS)];
+    u8 transposed  = u8(rng_below(rng, 2));
+
+    for (u8 r = 0; r < 9; r++) {
+        for (u8 c = 0; c < 9; c++) {
+            t->cells[r*9 + c] = transposed ? cols[c]*9 + rows[r] : rows[r]*9 + cols[c];
+        }
+    }
+
+    t->digits[0] = 0;
+    for (u8 d = 1; d < 10; d++) t->digits[d] = d;
+    for (u8 d = 9; d > 1; d--) {
+        u8 j = u8(1 + rng_below(rng, d));
+        u8 tmp = t->digits[d];
+        t->digits[d] = t->digits[j];
+        t->digits[j] = tmp;
+    }
+}
+
+
+
+// -- Canonical Form
+#define CANON_INITIAL_CAPACITY  (2 * 9 * N_COL_PERMS)
+
+void canon_init(CanonWork* work) {
+    work->capacity = CANON_INITIAL_CAPACITY;
+    work->current  = (CanonState*) malloc(sizeof(CanonState) * work->capacity);
+    work->next     = (CanonState*) malloc(sizeof(CanonState) * work->capacity);
+}
+
+void canon_free(CanonWork* work) {
+    free(work->current);
+    free(work->next);
+    work->current  = NULL;
+    work->next     = NULL;
+    work->capacity = 0;
+}
+
+void _canon_grow(CanonWork* work) {
+    work->capacity *= 2;
+    work->current = (CanonState*) realloc(work->current, sizeof(CanonState) * work->capacity);
+    work->next    = (CanonState*) realloc(work->next,    sizeof(CanonState) * work->capacity);
+}
+
+void board_to_digits(u16* board, u8* digits) {
+    for (u8 i = 0; i < BOARD_SIZE; i++) {
+        u16 cell = board[i];
+        if ((cell & BOARD_FLAG_PENCIL) && !(cell & BOARD_FLAG_STATIC)) digits[i] = 0;
+        else digits[i] = BIT_DIGIT(cell);
+    }
+}
+
+// writes one output row, relabeling unseen digits, returns the row string in row
+void _canon_row(u8* grid, u8 src_row, const u8* cols, u8* map, u8* next_label, u8* row) {
+    u8* src = &grid[src_row * 9];
+    for (u8 c = 0; c < 9; c++) {
+        u8 d = src[cols[c]];
+        if (d && !map[d]) {
+            map[d] = *next_label;
+            (*next_label)++;
+        }
+        row[c] = map[d];
+    }
+}
+
+// same as _canon_row, but gives up as soon as the row is worse than best
+i8 _canon_row_cmp(u8* grid, u8 src_row, const u8* cols, u8* map, u8* next_label, u8* row, u8* best) {
+    u8* src = &grid[src_row * 9];
+    i8  cmp = 0;
+    for (u8 c = 0; c < 9; c++) {
+        u8 d = src[cols[c]];
+        if (d && !map[d]) {
+            map[d] = *next_label;
+            (*next_label)++;
+        }
+        row[c] = map[d];
+        if (!cmp && row[c] != best[c]) {
+            cmp = (row[c] < best[c]) ? -1 : 1;
+            if (cmp > 0) return cmp;
+        }
+    }
+    return cmp;
+}
+
+// -1, 0, 1 like memcmp, but only over 9 bytes and without the call
+i8 _canon_cmp(u8* a, u8* b) {
+    for (u8 i = 0; i < 9; i++) {
+        if (a[i] != b[i]) return (a[i] < b[i]) ? -1 : 1;
+    }
+    return 0;
+}
+
+/*
+    smallest first row reachable from src, without enumerating: with every
+    digit distinct the string is only shaped by the zeros, so stacks go by
+    zero count and zeros lead inside each stack. returns 0 if the row
+    repeats a digit, the bound doesn't hold then.
+*/
+u8 _canon_first_row(u8* src, u8* row) {
+    u16 seen = 0;
+    u8  zeros[3] = {0};
+    for (u8 c = 0; c < 9; c++) {
+        if (!src[c]) { zeros[c/3]++; continue; }
+        if (seen & (1 << src[c])) return 0;
+        seen |= 1 << src[c];
+    }
+
+    // sort zero counts, descending
+    for (u8 i = 0; i < 2; i++) {
+        for (u8 j = i + 1; j < 3; j++) {
+            if (zeros[j] > zeros[i]) { u8 tmp = zeros[i]; zeros[i] = zeros[j]; zeros[j] = tmp; }
+        }
+    }
+
+    u8 label = 1;
+    for (u8 k = 0; k < 3; k++) {
+        for (u8 j = 0; j < 3; j++) {
+            row[k*3 + j] = (j < zeros[k]) ? 0 : label++;
+        }
+    }
+    return 1;
+}
+
+void _canon_transform(CanonState* s, Transform* t) {
+    for (u8 r = 0; r < 9; r++) {
+        for (u8 c = 0; c < 9; c++) {
+            u8 col = col_perms.cols[s->col_perm][c];
+            if (s->transposed) t->cells[r*9 + c] = col * 9 + s->rows[r];
+            else               t->cells[r*9 + c] = s->rows[r] * 9 + col;
+        }
+    }
+
+    // digits that never appear take the remaining labels in order
+    u8 label = s->next_label;
+    t->digits[0] = 0;
+    for (u8 d = 1; d < 10; d++) {
+        t->digits[d] = s->map[d] ? s->map[d] : label++;
+    }
+}
+
+void canonicalize(CanonWork* work, u8* digits, Canon* out) {
+    u8 grid[2][BOARD_SIZE];
+    for (u8 i = 0; i < BOARD_SIZE; i++) {
+        grid[0][i] = digits[i];
+        grid[1][i] = digits[board_tables.col[i]*9 + board_tables.row[i]];
+    }
+
+    u8  best[9];
+    u8  row[9];
+    u8  have_best = 0;
+    u32 n_current = 0;
+    u32 n_next    = 0;
+
+    // bound the first row before enumerating any column permutation
+    u8 bounded[2][9];
+    for (u8 t = 0; t < 2; t++) {
+        for (u8 r = 0; r < 9; r++) {
+            bounded[t][r] = _canon_first_row(&grid[t][r*9], row);
+            if (bounded[t][r] && (!have_best || _canon_cmp(row, best) < 0)) {
+                memcpy(best, row, 9);
+                have_best = 1;
+            }
+        }
+    }
+
+    // every row repeats a digit, any reachable row will do as the bound
+    if (!have_best) {
+        u8 map[10]    = {0};
+        u8 next_label = 1;
+        _canon_row(grid[0], 0, col_perms.cols[0], map, &next_label, best);
+        have_best = 1;
+    }
+
+    // first row -- every transposition, top row and column permutation,
+    // picked one stack at a time so a worse prefix cuts the whole subtree
+    const u8 perm3[6][3] = {{0,1,2},{0,2,1},{1,0,2},{1,2,0},{2,0,1},{2,1,0}};
+
+    #define CANON_PREFIX(k) \
+        for (u8 j = 0; j < 3; j++) {\
+            u8 d = src[stack[k]*3 + perm3[inner[k]][j]];\
+            if (d && !map[k+1][d]) map[k+1][d] = labels[k+1]++;\
+            row[k*3 + j] = map[k+1][d];\
+        }\
+        /* only the new stack needs comparing while the prefix is tied */\
+        order[k+1] = order[k];\
+        for (u8 j = k*3; j < (k+1)*3 && !order[k+1]; j++) {\
+            if (row[j] != best[j]) order[k+1] = (row[j] < best[j]) ? -1 : 1;\
+        }\
+        if (order[k+1] > 0) continue;
+
+    for (u8 t = 0; t < 2; t++) {
+        for (u8 r = 0; r < 9; r++) {
+            u8* src = &grid[t][r*9];
+
+            // can't reach the best first row
+            if (bounded[t][r] && have_best) {
+                _canon_first_row(src, row);
+                if (_canon_cmp(row, best) > 0) continue;
+            }
+
+            u8 stack[3];
+            u8 inner[3];
+            u8 map[4][10] = {{0}};
+            u8 labels[4]  = {1};
+            i8 order[4]   = {0};
+
+            for (stack[0] = 0; stack[0] < 3; stack[0]++) {
+                for (inner[0] = 0; inner[0] < 6; inner[0]++) {
+                    memcpy(map[1], map[0], 10); labels[1] = labels[0];
+                    CANON_PREFIX(0);
+
+                    for (u8 s1 = 0; s1 < 2; s1++) {
+                        stack[1] = (stack[0] + 1 + s1) % 3;
+                        stack[2] = 3 - stack[0] - stack[1];
+
+                        for (inner[1] = 0; inner[1] < 6; inner[1]++) {
+                            memcpy(map[2], map[1], 10); labels[2] = labels[1];
+                            CANON_PREFIX(1);
+
+                            for (inner[2] = 0; inner[2] < 6; inner[2]++) {
+                                memcpy(map[3], map[2], 10); labels[3] = labels[2];
+                                CANON_PREFIX(2);
+
+                                if (order[3] < 0) {
+                                    // new best, the current path is now tied with it
+                                    memcpy(best, row, 9);
+                                    order[1]  = 0;
+                                    order[2]  = 0;
+                                    order[3]  = 0;
+                                    n_current = 0;
+                                }
+
+                                // index into col_perms, stack orders are listed like perm3
+                                u8  stacks = stack[0]*2 + u8(stack[1] > stack[2]);
+                                u16 p      = stacks*216 + inner[0]*36 + inner[1]*6 + inner[2];
+
+                                CanonState* s = &work->current[n_current++];
+                                s->transposed = t;
+                                s->rows[0]    = r;
+                                s->col_perm   = p;
+                                s->next_label = labels[3];
+                                memcpy(s->map, map[3], 10);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    #undef CANON_PREFIX
+    memcpy(&out->minlex[0], best, 9);
+
+    // remaining rows -- bands stay together, so a row either starts a new
+    // band or continues the band of the previous row
+    for (u8 k = 1; k < 9; k++) {
+        n_next = 0;
+
+        for (u32 i = 0; i < n_current; i++) {
+            CanonState* s = &work->current[i];
+
+            u16 used = 0;
+            for (u8 j = 0; j < k; j++) used |= 1 << s->rows[j];
+
+            u8 lower = 0, upper = 9;
+            if (k % 3) {
+                lower = (s->rows[k-1] / 3) * 3;
+                upper = lower + 3;
+            }
+
+            for (u8 r = lower; r < upper; r++) {
+                if (used & (1 << r)) continue;
+                if (!(k % 3)) {
+                    // new band, only its rows that aren't in a used band
+                    u8 band = r / 3;
+                    if (used & (0x7 << (band*3))) continue;
+                }
+
+                u8 map[10];
+                u8 next_label = s->next_label;
+                memcpy(map, s->map, 10);
+                i8 cmp = -1;
+                if (n_next) cmp = _canon_row_cmp(grid[s->transposed], r, col_perms.cols[s->col_perm], map, &next_label, row, best);
+                else        _canon_row(grid[s->transposed], r, col_perms.cols[s->col_perm], map, &next_label, row);
+                if (cmp > 0) continue;
+                if (cmp < 0) {
+                    memcpy(best, row, 9);
+                    n_next = 0;
+                }
+
+                if (n_next == work->capacity) {
+                    // grow keeps the buffers, but next is addressed through work
+                    _canon_grow(work);
+                    s = &work->current[i];
+                }
+
+                CanonState* c = &work->next[n_next++];
+                *c = *s;
+                c->rows[k]    = r;
+                c->next_label = next_label;
+                memcpy(c->map, map, 10);
+            }
+        }
+
+        memcpy(&out->minlex[k*9], best, 9);
+
+        CanonState* tmp = work->current;
+        work->current   = work->next;
+        work->next      = tmp;
+        n_current       = n_next;
+    }
+
+    // automorphisms -- s0^-1 after si for every surviving transform si
+    _canon_transform(&work->current[0], &out->to_minlex);
+
+    Transform inverse;
+    for (u8 i = 0; i < BOARD_SIZE; i++) inverse.cells[out->to_minlex.cells[i]] = i;
+    for (u8 d = 0; d < 10; d++) inverse.digits[out->to_minlex.digits[d]] = d;
+
+    out->n_automorphisms = n_current;
+    for (u32 i = 0; i < n_current && i < CANON_MAX_AUTOMORPHISMS; i++) {
+        Transform t;
+        _canon_transform(&work->current[i], &t);
+        compose_transform(&inverse, &t, &out->automorphisms[i]);
+    }
+}
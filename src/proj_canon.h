@@ -0,0 +1,117 @@
+#ifndef PROJ_CANON_H
+#define PROJ_CANON_H
+
+// local
+#include "proj_types.h"
+#include "proj_board.h"
+#include "proj_rand.h"
+
+// system
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+
+
+/*
+    validity preserving transform: out[i] = digits[in[cells[i]]]
+
+    digits[0] is always 0 so empty cells stay empty. every element of the
+    sudoku group (band, stack, row and col permutations, transposition and
+    relabeling) can be written this way.
+*/
+struct Transform {
+    u8 cells[BOARD_SIZE];
+    u8 digits[10];
+};
+
+void identity_transform(Transform* t);
+void apply_transform(Transform* t, u8* in, u8* out);
+void compose_transform(Transform* a, Transform* b, Transform* out);   // out = a after b
+
+// uniformly random element of the group
+void random_transform(Transform* t, Rng* rng);
+
+
+/*
+    column permutations that keep stacks intact, 3! stack orders times 3!
+    column orders inside each stack, built at compile time
+*/
+#define N_COL_PERMS     1296
+
+struct ColPerms {
+    u8 cols[N_COL_PERMS][9];
+};
+
+constexpr ColPerms build_col_perms() {
+    ColPerms p = {};
+    const u8 perm3[6][3] = {{0,1,2},{0,2,1},{1,0,2},{1,2,0},{2,0,1},{2,1,0}};
+
+    u32 n = 0;
+    for (u32 s = 0; s < 6; s++) {
+        for (u32 a = 0; a < 6; a++) {
+            for (u32 b = 0; b < 6; b++) {
+                for (u32 c = 0; c < 6; c++) {
+                    const u32 inner[3] = {a, b, c};
+                    for (u32 k = 0; k < 3; k++) {
+                        u32 stack = perm3[s][k];
+                        for (u32 j = 0; j < 3; j++) {
+                            p.cols[n][k*3 + j] = stack*3 + perm3[inner[k]][j];
+                        }
+                    }
+                    n++;
+                }
+            }
+        }
+    }
+    return p;
+}
+
+constexpr ColPerms col_perms = build_col_perms();
+
+
+/*
+    minlex canonical form
+
+    the lexicographically smallest 81 digit string (0 for empty) reachable
+    through the sudoku group, digits relabeled in order of appearance.
+    built one output row at a time, keeping only the partial transforms
+    tied for the smallest prefix, so most of the 2*6^8 transforms are never
+    looked at.
+
+    every transform reaching the minimum maps the puzzle onto the same
+    string, so the survivors give the automorphism group for free.
+*/
+#define CANON_MAX_AUTOMORPHISMS     648
+
+struct CanonState {
+    u8  transposed;
+    u8  rows[9];
+    u16 col_perm;
+    u8  map[10];
+    u8  next_label;
+};
+
+// scratch space, reused between calls -- one per thread
+struct CanonWork {
+    u32         capacity = 0;
+    CanonState* current  = NULL;
+    CanonState* next     = NULL;
+};
+
+struct Canon {
+    u8        minlex[BOARD_SIZE];
+    Transform to_minlex;                // puzzle -> minlex
+
+    // identity included, only the first CANON_MAX_AUTOMORPHISMS are kept
+    u32       n_automorphisms;
+    Transform automorphisms[CANON_MAX_AUTOMORPHISMS];
+};
+
+void canon_init(CanonWork* work);
+void canon_free(CanonWork* work);
+
+void board_to_digits(u16* board, u8* digits);
+void canonicalize(CanonWork* work, u8* digits, Canon* out);
+
+#endif
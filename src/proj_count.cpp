@@ -0,0 +1,619 @@
+#include "proj_count.h"
+
+
+// -- 128 bit
+u128 u128_from(u64 v) {
+    u128 r;
+    r.lo = v;
+    r.hi = 0;
+    return r;
+}
+
+u128 u128_add(u128 a, u128 b) {
+    u128 r;
+    r.lo = a.lo + b.lo;
+    r.hi = a.hi + b.hi + u64(r.lo < a.lo);
+    return r;
+}
+
+// 32 bit limbs, no compiler intrinsics needed
+u128 u128_mul(u128 a, u64 b) {
+    u64 limbs[4] = {a.lo & 0xFFFFFFFF, a.lo >> 32, a.hi & 0xFFFFFFFF, a.hi >> 32};
+    u64 b_lo = b & 0xFFFFFFFF;
+    u64 b_hi = b >> 32;
+
+    u64 out[5] = {0};
+    for (u8 i = 0; i < 4; i++) {
+        u64 carry = 0;
+        for (u8 j = 0; j < 2 && i + j < 5; j++) {
+            u64 p = limbs[i] * (j ? b_hi : b_lo) + (out[i + j] & 0xFFFFFFFF) + carry;
+            out[i + j] = p & 0xFFFFFFFF;
+            carry = p >> 32;
+        }
+        for (u8 k = i + 2; k < 5 && carry; k++) {
+            u64 p = out[k] + carry;
+            out[k] = p & 0xFFFFFFFF;
+            carry = p >> 32;
+        }
+    }
+
+    u128 r;
+    r.lo = out[0] | (out[1] << 32);
+    r.hi = out[2] | (out[3] << 32);
+    return r;
+}
+
+u8 u128_equal(u128 a, u128 b) {
+    return a.lo == b.lo && a.hi == b.hi;
+}
+
+void u128_to_string(u128 v, char* out) {
+    char digits[40];
+    u8   n = 0;
+
+    // long division by 10 over 32 bit limbs
+    u32 limbs[4] = {u32(v.hi >> 32), u32(v.hi), u32(v.lo >> 32), u32(v.lo)};
+    do {
+        u64 rem = 0;
+        u8  zero = 1;
+        for (u8 i = 0; i < 4; i++) {
+            u64 cur  = (rem << 32) | limbs[i];
+            limbs[i] = u32(cur / 10);
+            rem      = cur % 10;
+            if (limbs[i]) zero = 0;
+        }
+        digits[n++] = char('0' + rem);
+        if (zero) break;
+    } while (1);
+
+    for (u8 i = 0; i < n; i++) out[i] = digits[n - 1 - i];
+    out[n] = 0;
+}
+
+
+
+// -- Puzzle
+struct _CountPuzzle {
+    u8  digits[BOARD_SIZE];     // densest band moved to the top
+    u8  clued[3];               // band has a clue
+    u16 absent;                 // digits without any clue
+    u16 lower;                  // digits clued below the top band
+    u8  n_clues;
+
+    // column and stack permutations keeping the lower clues, col -> col
+    u16 n_moves;
+    u8  moves[6*6*6*6][9];
+};
+
+const u8 _perm3[6][3] = {{0,1,2},{0,2,1},{1,0,2},{1,2,0},{2,0,1},{2,1,0}};
+
+void _count_prepare(u16* board, _CountPuzzle* p) {
+    u8 digits[BOARD_SIZE];
+    for (u8 i = 0; i < BOARD_SIZE; i++) {
+        u16 cell = board[i];
+        digits[i] = ((cell & BOARD_FLAG_PENCIL) && !(cell & BOARD_FLAG_STATIC)) ? 0 : BIT_DIGIT(cell);
+    }
+
+    // bands (0-2) and stacks (3-5), transposing turns a stack into a band
+    u8 clues[6] = {0};
+    for (u8 i = 0; i < BOARD_SIZE; i++) {
+        if (!digits[i]) continue;
+        clues[board_tables.row[i] / 3]++;
+        clues[3 + board_tables.col[i] / 3]++;
+    }
+    u8 best = 0;
+    for (u8 b = 1; b < 6; b++) if (clues[b] > clues[best]) best = b;
+
+    for (u8 i = 0; i < BOARD_SIZE; i++) {
+        u8 r = board_tables.row[i];
+        u8 c = board_tables.col[i];
+        if (best >= 3) { u8 tmp = r; r = c; c = tmp; }
+
+        // swap the chosen band with the top one
+        u8 band = r / 3;
+        u8 top  = best % 3;
+        if      (band == top) r = r % 3;
+        else if (band == 0)   r = top * 3 + r % 3;
+        p->digits[r*9 + c] = digits[i];
+    }
+
+    p->absent  = BOARD_ALL;
+    p->lower   = 0;
+    p->n_clues = 0;
+    for (u8 b = 0; b < 3; b++) p->clued[b] = 0;
+    for (u8 i = 0; i < BOARD_SIZE; i++) {
+        if (!p->digits[i]) continue;
+        p->absent &= ~u16(1 << (p->digits[i] - 1));
+        if (i >= 27) p->lower |= 1 << (p->digits[i] - 1);
+        p->clued[i / 27] = 1;
+        p->n_clues++;
+    }
+    p->n_moves = 0;
+    for (u8 s = 0; s < 6; s++) {
+        for (u8 i = 0; i < 6; i++) for (u8 j = 0; j < 6; j++) for (u8 k = 0; k < 6; k++) {
+            const u8* order[3] = {_perm3[i], _perm3[j], _perm3[k]};
+            u8* move = p->moves[p->n_moves];
+            for (u8 c = 0; c < 9; c++) move[c] = _perm3[s][c / 3]*3 + order[c / 3][c % 3];
+
+            u8 keeps = 1;
+            for (u8 cell = 27; cell < BOARD_SIZE && keeps; cell++) {
+                u8 r = cell / 9;
+                u8 c = cell % 9;
+                if (p->digits[r*9 + move[c]] != p->digits[cell]) keeps = 0;
+            }
+            if (keeps) p->n_moves++;
+        }
+    }
+}
+
+
+
+// -- Gangster Map
+struct _GangsterMap {
+    u32       mask;
+    u32       count;
+    Gangster* slots;
+};
+
+void _map_init(_GangsterMap* map, u8 log2_slots) {
+    map->mask  = (1u << log2_slots) - 1;
+    map->count = 0;
+    map->slots = (Gangster*) calloc(u64(map->mask) + 1, sizeof(Gangster));
+}
+
+u32 _map_hash(u16* cols) {
+    u64 h = 0xCBF29CE484222325ull;
+    for (u8 c = 0; c < 9; c++) h = (h ^ cols[c]) * 0x100000001B3ull;
+    return u32(h ^ (h >> 32));
+}
+
+// weight 0 marks an empty slot, every insert adds at least 1
+void _map_add(_GangsterMap* map, u16* cols, u64 weight) {
+    if (2 * (map->count + 1) > map->mask) {
+        _GangsterMap grown;
+        grown.mask  = map->mask * 2 + 1;
+        grown.count = 0;
+        grown.slots = (Gangster*) calloc(u64(grown.mask) + 1, sizeof(Gangster));
+        for (u32 i = 0; i <= map->mask; i++) {
+            if (map->slots[i].weight) _map_add(&grown, map->slots[i].cols, map->slots[i].weight);
+        }
+        free(map->slots);
+        *map = grown;
+    }
+
+    u32 i = _map_hash(cols) & map->mask;
+    while (map->slots[i].weight) {
+        if (!memcmp(map->slots[i].cols, cols, sizeof(u16) * 9)) {
+            map->slots[i].weight += weight;
+            return;
+        }
+        i = (i + 1) & map->mask;
+    }
+
+    memcpy(map->slots[i].cols, cols, sizeof(u16) * 9);
+    map->slots[i].weight      = weight;
+    map->slots[i].completions = 0;
+    map->count++;
+}
+
+
+
+// -- Gangster Classes
+/*
+    the bands below only see the top band through its gangster and only
+    tell apart the digits clued in them. every other digit is only a digit
+    -> (column in each stack) map up to relabeling, so those reduce to how
+    many digits land on each of the 27 column triples. column and stack
+    permutations that keep the lower clues in place don't change the count
+    either, and the smallest gangster over them picks one per class.
+*/
+void _gangster_triples(u16* cols, u16 free_digits, u8* triples) {
+    memset(triples, 0, 27);
+    for (u8 d = 0; d < 9; d++) {
+        if (!(free_digits & (1 << d))) continue;
+        u8 at[3] = {0};
+        for (u8 c = 0; c < 9; c++) if (cols[c] & (1 << d)) at[c / 3] = c % 3;
+        triples[at[0]*9 + at[1]*3 + at[2]]++;
+    }
+}
+
+// the free digits, smallest first, go to the triples in order
+void _gangster_from_triples(u8* triples, u16 free_digits, u16* cols) {
+    for (u8 c = 0; c < 9; c++) cols[c] &= ~free_digits;
+    for (u8 t = 0; t < 27; t++) {
+        for (u8 k = 0; k < triples[t]; k++) {
+            u16 bit = free_digits & (~free_digits + 1);
+            free_digits ^= bit;
+            cols[t / 9]         |= bit;
+            cols[3 + t / 3 % 3] |= bit;
+            cols[6 + t % 3]     |= bit;
+        }
+    }
+}
+
+void _relabel_gangster(u16* cols, u16 free_digits) {
+    u8 triples[27];
+    _gangster_triples(cols, free_digits, triples);
+    _gangster_from_triples(triples, free_digits, cols);
+}
+
+/*
+    smallest relabeled gangster over the column moves that keep the lower
+    clues, compared as the triple counts of the free digits and then the
+    triple of each clued one, which is all a relabeled gangster holds
+*/
+void _permute_gangster(u16* cols, _CountPuzzle* p) {
+    const u8 weights[3] = {9, 3, 1};
+
+    u8 at[9][3];
+    for (u8 c = 0; c < 9; c++) {
+        for (u8 d = 0; d < 9; d++) if (cols[c] & (1 << d)) at[d][c / 3] = c;
+    }
+
+    u8  best[27 + 9];
+    u16 best_move = 0;
+    for (u16 m = 0; m < p->n_moves; m++) {
+        u8* move = p->moves[m];
+
+        u8 key[27 + 9] = {0};
+        for (u8 d = 0; d < 9; d++) {
+            u8 t = 0;
+            for (u8 s = 0; s < 3; s++) t += (move[at[d][s]] % 3) * weights[move[at[d][s]] / 3];
+            if (p->lower & (1 << d)) key[27 + d] = t;
+            else                     key[t]++;
+        }
+        if (!m || memcmp(key, best, sizeof(best)) < 0) {
+            memcpy(best, key, sizeof(best));
+            best_move = m;
+        }
+    }
+
+    u16 moved[9];
+    for (u8 c = 0; c < 9; c++) moved[p->moves[best_move][c]] = cols[c];
+    _relabel_gangster(moved, BOARD_ALL & ~p->lower);
+    memcpy(cols, moved, sizeof(moved));
+}
+
+
+
+// -- Top Bands
+struct _TopSearch {
+    _CountPuzzle* puzzle;
+    _GangsterMap* map;
+    u64           n_bands;
+
+    u16 rows[3];
+    u16 boxes[3];
+    u16 cols[9];
+    u16 seen;                   // absent digits used so far
+};
+
+// absent digits only appear in increasing order, every other order is a relabeling
+void _top_search(_TopSearch* t, u8 i) {
+    if (i == 27) {
+        u16 cols[9];
+        memcpy(cols, t->cols, sizeof(cols));
+        _relabel_gangster(cols, BOARD_ALL & ~t->puzzle->lower);
+        _map_add(t->map, cols, 1);
+        t->n_bands++;
+        return;
+    }
+
+    u8  r = i / 9;
+    u8  c = i % 9;
+    u8  b = c / 3;
+    u16 free_digits = BOARD_ALL & ~(t->rows[r] | t->boxes[b] | t->cols[c]);
+
+    u8 clue = t->puzzle->digits[i];
+    if (clue) {
+        free_digits &= 1 << (clue - 1);
+    } else {
+        // every seen absent digit, and the smallest unseen one
+        u16 unseen = t->puzzle->absent & ~t->seen;
+        u16 first  = unseen & (~unseen + 1);
+        free_digits &= ~(unseen & ~first);
+    }
+
+    while (free_digits) {
+        u16 bit = free_digits & (~free_digits + 1);
+        free_digits ^= bit;
+
+        u16 seen = t->seen;
+        t->rows[r] |= bit; t->boxes[b] |= bit; t->cols[c] |= bit;
+        t->seen    |= bit & t->puzzle->absent;
+
+        _top_search(t, i + 1);
+
+        t->rows[r] ^= bit; t->boxes[b] ^= bit; t->cols[c] ^= bit;
+        t->seen     = seen;
+    }
+}
+
+
+
+// -- Completions
+#define COUNT_SPLITS        56      // column set splits of one stack
+#define COUNT_ROW_SPLITS    216     // row orders of one stack of one band
+#define COUNT_KEYS          (COUNT_RANKS * COUNT_RANKS)
+
+struct _StackSplit {
+    u16 sets[2][3];             // column sets of the middle and bottom band
+};
+
+/*
+    column sets the two lower bands can take under one stack of the top
+    band: each middle set avoids its top set, the three of them partition
+    the digits, and the bottom set is whatever is left in the column
+*/
+u8 _stack_splits(u16* top, u8* mid_clues, u8* low_clues, _StackSplit* out) {
+    // digits a column's set must hold, from the clues of that band
+    u16 need[2][3] = {};
+    for (u8 r = 0; r < 3; r++) {
+        for (u8 c = 0; c < 3; c++) {
+            if (mid_clues[r*9 + c]) need[0][c] |= 1 << (mid_clues[r*9 + c] - 1);
+            if (low_clues[r*9 + c]) need[1][c] |= 1 << (low_clues[r*9 + c] - 1);
+        }
+    }
+
+    u8 n = 0;
+    for (u16 a = 0; a <= BOARD_ALL; a++) {
+        if (RANK3(a) == 0xFF || (a & top[0])) continue;
+        for (u16 b = 0; b <= BOARD_ALL; b++) {
+            if (RANK3(b) == 0xFF || (b & (top[1] | a))) continue;
+            u16 c = BOARD_ALL & ~(a | b);
+            if (c & top[2]) continue;
+
+            _StackSplit* s = &out[n];
+            s->sets[0][0] = a;
+            s->sets[0][1] = b;
+            s->sets[0][2] = c;
+            for (u8 k = 0; k < 3; k++) s->sets[1][k] = BOARD_ALL & ~(top[k] | s->sets[0][k]);
+
+            u8 ok = 1;
+            for (u8 band = 0; band < 2; band++) {
+                for (u8 k = 0; k < 3; k++) {
+                    if ((s->sets[band][k] & need[band][k]) != need[band][k]) ok = 0;
+                }
+            }
+            if (ok) n++;
+        }
+    }
+    return n;
+}
+
+/*
+    ways to order the digits of one column into the band's rows that keep
+    the band's clues in place, as the digit bit of each row. sorted keeps
+    the column in ascending order only.
+*/
+u8 _column_orders(u16 col, u8* clues, u8 sorted, u16 (*out)[3]) {
+    u16 bits[3];
+    for (u8 k = 0; k < 3; k++) {
+        bits[k] = col & (~col + 1);
+        col    ^= bits[k];
+    }
+
+    u8 n = 0;
+    for (u8 o = 0; o < (sorted ? 1 : 6); o++) {
+        u8 ok = 1;
+        for (u8 r = 0; r < 3; r++) {
+            u16 clue = clues[r*9] ? 1 << (clues[r*9] - 1) : 0;
+            if (clue && bits[_perm3[o][r]] != clue) ok = 0;
+        }
+        if (!ok) continue;
+        for (u8 r = 0; r < 3; r++) out[n][r] = bits[_perm3[o][r]];
+        n++;
+    }
+    return n;
+}
+
+// row masks of every combination of column orders of one stack
+u16 _row_splits(u16* cols, u8* clues, u8 sorted_first, u16* out) {
+    u16 orders[3][6][3];
+    u8  n_orders[3];
+    for (u8 c = 0; c < 3; c++) n_orders[c] = _column_orders(cols[c], &clues[c], sorted_first && !c, orders[c]);
+
+    u16 n = 0;
+    for (u8 i = 0; i < n_orders[0]; i++) {
+        for (u8 j = 0; j < n_orders[1]; j++) {
+            for (u8 k = 0; k < n_orders[2]; k++) {
+                for (u8 r = 0; r < 3; r++) out[n*3 + r] = orders[0][i][r] | orders[1][j][r] | orders[2][k][r];
+                n++;
+            }
+        }
+    }
+    return n;
+}
+
+#define ROW_KEY(r0, r1)     (u16(RANK3(r0)) * COUNT_RANKS + RANK3(r1))
+
+/*
+    one lower band of one gangster. once stacks 0 and 1 are ordered, stack
+    2 rows are what's left, so each compatible pair of orders counts once
+    for every stack 2 split holding those rows. the stack 1 orders that fit
+    a stack 0 order are picked column by column, and the stack 2 splits are
+    bucketed by their row key.
+*/
+struct _BandWork {
+    u16 rows0[COUNT_ROW_SPLITS * 3];
+    u16 n_rows0;
+
+    u16 orders1[COUNT_SPLITS][3][6][3];
+    u8  n_orders1[COUNT_SPLITS][3];
+
+    u16 key_first[COUNT_KEYS + 1];
+    u8  key_splits[COUNT_SPLITS * COUNT_ROW_SPLITS];
+
+    u32 sums[COUNT_SPLITS];     // per stack 2 split, for the current stack 0 and 1 splits
+};
+
+struct _CompletionWork {
+    _StackSplit splits[3][COUNT_SPLITS];
+    u8          n_splits[3];
+    _BandWork   bands[2];
+};
+
+void _band_prepare(_CompletionWork* w, u8 band, u8* clues) {
+    _BandWork* b = &w->bands[band];
+
+    for (u8 i = 0; i < w->n_splits[1]; i++) {
+        u16* cols = w->splits[1][i].sets[band];
+        for (u8 c = 0; c < 3; c++) b->n_orders1[i][c] = _column_orders(cols[c], &clues[3 + c], 0, b->orders1[i][c]);
+    }
+
+    // counting sort of every stack 2 row split by key
+    u16 rows[COUNT_ROW_SPLITS * 3];
+    memset(b->key_first, 0, sizeof(b->key_first));
+    for (u8 i = 0; i < w->n_splits[2]; i++) {
+        u16 n = _row_splits(w->splits[2][i].sets[band], &clues[6], 0, rows);
+        for (u16 j = 0; j < n; j++) b->key_first[ROW_KEY(rows[j*3], rows[j*3 + 1]) + 1]++;
+    }
+    for (u16 k = 0; k < COUNT_KEYS; k++) b->key_first[k + 1] += b->key_first[k];
+
+    u16 next[COUNT_KEYS];
+    memcpy(next, b->key_first, sizeof(next));
+    for (u8 i = 0; i < w->n_splits[2]; i++) {
+        u16 n = _row_splits(w->splits[2][i].sets[band], &clues[6], 0, rows);
+        for (u16 j = 0; j < n; j++) b->key_splits[next[ROW_KEY(rows[j*3], rows[j*3 + 1])]++] = i;
+    }
+}
+
+void _band_sums(_BandWork* b, u8 i1) {
+    memset(b->sums, 0, sizeof(b->sums));
+
+    for (u16 i = 0; i < b->n_rows0; i++) {
+        u16* a = &b->rows0[i*3];
+
+        // orders of each stack 1 column that miss stack 0's rows
+        u16 fits[3][6][3];
+        u8  n_fits[3] = {0};
+        for (u8 c = 0; c < 3; c++) {
+            for (u8 o = 0; o < b->n_orders1[i1][c]; o++) {
+                u16* order = b->orders1[i1][c][o];
+                if ((order[0] & a[0]) | (order[1] & a[1]) | (order[2] & a[2])) continue;
+                memcpy(fits[c][n_fits[c]++], order, sizeof(u16) * 3);
+            }
+            if (!n_fits[c]) break;
+        }
+        if (!n_fits[0] || !n_fits[1] || !n_fits[2]) continue;
+
+        for (u8 x = 0; x < n_fits[0]; x++) {
+            for (u8 y = 0; y < n_fits[1]; y++) {
+                for (u8 z = 0; z < n_fits[2]; z++) {
+                    u16 r0 = a[0] | fits[0][x][0] | fits[1][y][0] | fits[2][z][0];
+                    u16 r1 = a[1] | fits[0][x][1] | fits[1][y][1] | fits[2][z][1];
+                    u16 key = ROW_KEY(BOARD_ALL & ~r0, BOARD_ALL & ~r1);
+                    for (u16 k = b->key_first[key]; k < b->key_first[key + 1]; k++) b->sums[b->key_splits[k]]++;
+                }
+            }
+        }
+    }
+}
+
+u64 _completions(Gangster* g, _CountPuzzle* p, _CompletionWork* w) {
+    u8* clues[2] = {&p->digits[27], &p->digits[54]};
+
+    for (u8 k = 0; k < 3; k++) {
+        w->n_splits[k] = _stack_splits(&g->cols[k*3], &clues[0][k*3], &clues[1][k*3], w->splits[k]);
+        if (!w->n_splits[k]) return 0;
+    }
+    for (u8 band = 0; band < 2; band++) _band_prepare(w, band, clues[band]);
+
+    // a band without clues keeps its rows sorted in stack 0, times 6
+    u8 sorted[2] = {u8(!p->clued[1]), u8(!p->clued[2])};
+
+    u64 total = 0;
+    for (u8 i0 = 0; i0 < w->n_splits[0]; i0++) {
+        u8 empty = 0;
+        for (u8 band = 0; band < 2; band++) {
+            _BandWork* b = &w->bands[band];
+            b->n_rows0 = _row_splits(w->splits[0][i0].sets[band], clues[band], sorted[band], b->rows0);
+            if (!b->n_rows0) empty = 1;
+        }
+        if (empty) continue;
+
+        for (u8 i1 = 0; i1 < w->n_splits[1]; i1++) {
+            _band_sums(&w->bands[0], i1);
+            _band_sums(&w->bands[1], i1);
+            for (u8 i2 = 0; i2 < w->n_splits[2]; i2++) total += u64(w->bands[0].sums[i2]) * w->bands[1].sums[i2];
+        }
+    }
+
+    if (sorted[0]) total *= 6;
+    if (sorted[1]) total *= 6;
+    return total;
+}
+
+struct _CountJob {
+    Gangster*     gangsters;
+    _CountPuzzle* puzzle;
+};
+
+void _count_gangster(void* args, u32 index, u32 worker) {
+    _CountJob* job = (_CountJob*) args;
+    _CompletionWork* w = (_CompletionWork*) malloc(sizeof(_CompletionWork));
+    job->gangsters[index].completions = _completions(&job->gangsters[index], job->puzzle, w);
+    free(w);
+}
+
+
+
+// -- Counting
+u128 count_bands(u16* board, ThreadPool* pool, BandCount* out) {
+    _CountPuzzle puzzle;
+    _count_prepare(board, &puzzle);
+
+    _GangsterMap map;
+    _map_init(&map, 12);
+
+    _TopSearch t;
+    memset(&t, 0, sizeof(t));
+    t.puzzle = &puzzle;
+    t.map    = &map;
+    _top_search(&t, 0);
+
+    _GangsterMap merged;
+    _map_init(&merged, 12);
+    for (u32 i = 0; i <= map.mask; i++) {
+        if (!map.slots[i].weight) continue;
+        u16 cols[9];
+        memcpy(cols, map.slots[i].cols, sizeof(cols));
+        _permute_gangster(cols, &puzzle);
+        _map_add(&merged, cols, map.slots[i].weight);
+    }
+    free(map.slots);
+    map = merged;
+
+    Gangster* gangsters = (Gangster*) malloc(sizeof(Gangster) * (map.count + 1));
+    u32 n_gangsters = 0;
+    for (u32 i = 0; i <= map.mask; i++) {
+        if (map.slots[i].weight) gangsters[n_gangsters++] = map.slots[i];
+    }
+    free(map.slots);
+
+    _CountJob job;
+    job.gangsters = gangsters;
+    job.puzzle    = &puzzle;
+    if (pool) pool_run(pool, _count_gangster, &job, n_gangsters);
+    else      for (u32 i = 0; i < n_gangsters; i++) _count_gangster(&job, i, 0);
+
+    u128 total = u128_from(0);
+    for (u32 i = 0; i < n_gangsters; i++) {
+        total = u128_add(total, u128_mul(u128_from(gangsters[i].completions), gangsters[i].weight));
+    }
+
+    // each enumerated top band stands for every relabeling of the absent digits
+    u32 factor = 1;
+    for (u8 k = 2; k <= BIT_COUNT(puzzle.absent); k++) factor *= k;
+    total = u128_mul(total, factor);
+
+    if (out) {
+        out->total          = total;
+        out->n_gangsters    = n_gangsters;
+        out->n_top_bands    = t.n_bands;
+        out->relabel_factor = factor;
+    }
+
+    free(gangsters);
+    return total;
+}
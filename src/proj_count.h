@@ -0,0 +1,84 @@
+#ifndef PROJ_COUNT_H
+#define PROJ_COUNT_H
+
+// local
+#include "proj_types.h"
+#include "proj_board.h"
+#include "proj_pool.h"
+
+// system
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+
+
+/*
+    128 bit unsigned, the empty grid alone has ~6.7e21 completions
+*/
+struct u128 {
+    u64 lo;
+    u64 hi;
+};
+
+u128 u128_from(u64 v);
+u128 u128_add(u128 a, u128 b);
+u128 u128_mul(u128 a, u64 b);
+u8   u128_equal(u128 a, u128 b);
+void u128_to_string(u128 v, char* out);   // decimal, out holds at least 40 chars
+
+
+/*
+    band decomposition counting
+
+    a grid is a top band plus the two bands under it. once the top band is
+    fixed, only the digit sets of its columns (the gangster) matter to the
+    bands below, and for each stack those bands can only take 56 column set
+    splits. the completions of a gangster are summed over these splits,
+    counting the row orders of each band stack by stack.
+
+    top bands are enumerated against the clues of the densest band, with
+    digits that aren't clued anywhere relabeled into first appearance order,
+    and bucketed by gangster class: relabeling the digits the lower bands
+    have no clue for, and moving columns and stacks around their clues,
+    doesn't change the count. every class is counted once, spread over the
+    pool. the empty grid comes down to 44 classes.
+*/
+#define COUNT_RANKS         84      // 3 element subsets of 9 digits
+
+struct CountTables {
+    u8 rank3[BOARD_ALL + 1];        // 3 element subset -> [0, 84), 0xFF otherwise
+};
+
+constexpr CountTables build_count_tables() {
+    CountTables t = {};
+    u8 n = 0;
+    for (u32 m = 0; m <= BOARD_ALL; m++) {
+        u32 bits = 0;
+        for (u32 d = 0; d < 9; d++) bits += (m >> d) & 0x1;
+        t.rank3[m] = (bits == 3) ? n++ : 0xFF;
+    }
+    return t;
+}
+
+constexpr CountTables count_tables = build_count_tables();
+
+#define RANK3(m)    (count_tables.rank3[m])
+
+struct Gangster {
+    u16 cols[9];                    // digit set of each top band column
+    u64 weight;                     // top bands sharing it
+    u64 completions;                // ways to fill the bands below
+};
+
+struct BandCount {
+    u128 total;
+    u32  n_gangsters;
+    u64  n_top_bands;               // enumerated, before the relabel factor
+    u32  relabel_factor;
+};
+
+// NULL pool counts on the calling thread
+u128 count_bands(u16* board, ThreadPool* pool, BandCount* out);
+
+#endif
@@ -0,0 +1,88 @@
+#include "proj_grids.h"
+
+// SSE2 is always there on x64
+#include <emmintrin.h>
+
+
+// -- Decoding
+u32 _grid_stride(u8 format) {
+    return format == GRID_FORMAT_NIBBLES ? GRID_NIBBLES : GRID_BYTES;
+}
+
+// digit bits of one grid, written into lane g
+void _grid_lane(const u8* grid, u8 format, u16 (*cells)[GRID_LANES], u8 g) {
+    if (format == GRID_FORMAT_BYTES) {
+        for (u8 i = 0; i < BOARD_SIZE; i++) cells[i][g] = grid_tables.onehot[grid[i]];
+        return;
+    }
+
+    for (u8 k = 0; k < BOARD_SIZE / 2; k++) {
+        cells[2*k + 0][g] = grid_tables.onehot[grid[k] & 0xF];
+        cells[2*k + 1][g] = grid_tables.onehot[grid[k] >> 4];
+    }
+    cells[BOARD_SIZE - 1][g] = grid_tables.onehot[grid[BOARD_SIZE / 2] & 0xF];
+}
+
+
+
+// -- Scalar
+u8 check_grid(const u8* grid, u8 format) {
+    u16 cells[BOARD_SIZE][GRID_LANES];
+    _grid_lane(grid, format, cells, 0);
+
+    for (u8 u = 0; u < N_UNITS; u++) {
+        const u8* unit = UNIT_CELLS(u);
+        u16 seen = 0;
+        for (u8 k = 0; k < BOARD_DIM; k++) seen |= cells[unit[k]][0];
+        if (seen != BOARD_ALL) return u;
+    }
+    return GRID_VALID;
+}
+
+
+
+// -- Batch
+u32 check_grids(const u8* grids, u32 n_grids, u8 format, u64* pass, u8* first_unit) {
+    u32 stride = _grid_stride(format);
+    u32 valid  = 0;
+
+    memset(pass, 0, sizeof(u64) * ((n_grids + 63) / 64));
+
+    u16 cells[BOARD_SIZE][GRID_LANES];
+    const __m128i all = _mm_set1_epi16(BOARD_ALL);
+
+    for (u32 base = 0; base < n_grids; base += GRID_LANES) {
+        u32 lanes = n_grids - base < GRID_LANES ? n_grids - base : GRID_LANES;
+        for (u8 g = 0; g < lanes; g++) _grid_lane(grids + u64(base + g) * stride, format, cells, g);
+
+        // unused lanes of the last batch start out failed, so they're never reported
+        u32 failed = 0xFFFF & ~((1u << (2*lanes)) - 1);
+        u8  first[GRID_LANES];
+        memset(first, GRID_VALID, sizeof(first));
+
+        for (u8 u = 0; u < N_UNITS && failed != 0xFFFF; u++) {
+            const u8* unit = UNIT_CELLS(u);
+            __m128i seen = _mm_loadu_si128((const __m128i*)cells[unit[0]]);
+            for (u8 k = 1; k < BOARD_DIM; k++) {
+                seen = _mm_or_si128(seen, _mm_loadu_si128((const __m128i*)cells[unit[k]]));
+            }
+
+            // two mask bits per u16 lane
+            u32 fresh = ~u32(_mm_movemask_epi8(_mm_cmpeq_epi16(seen, all))) & ~failed & 0xFFFF;
+            failed |= fresh;
+            for (u8 g = 0; fresh; g++, fresh >>= 2) {
+                if (fresh & 0x1) first[g] = u;
+            }
+        }
+
+        for (u8 g = 0; g < lanes; g++) {
+            u32 n = base + g;
+            if (first[g] == GRID_VALID) {
+                pass[n >> 6] |= u64(1) << (n & 63);
+                valid++;
+            }
+            if (first_unit) first_unit[n] = first[g];
+        }
+    }
+    return valid;
+}
@@ -0,0 +1,55 @@
+#ifndef PROJ_GRIDS_H
+#define PROJ_GRIDS_H
+
+// local
+#include "proj_types.h"
+#include "proj_board.h"
+
+// system
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+
+
+/*
+    batch checks of completed grids
+
+    grids are plain digits, not board cells, so streamed input can be
+    checked without going through the u16 flag layout. a grid is either 81
+    bytes or 41 bytes of nibbles (cell 2k in the low nibble of byte k),
+    packed back to back. anything outside 1-9 counts as a wrong digit.
+
+    8 grids are checked side by side in the u16 lanes of an SSE2 register,
+    one OR per cell of each of the 27 units.
+*/
+#define GRID_FORMAT_BYTES       0
+#define GRID_FORMAT_NIBBLES     1
+
+#define GRID_BYTES              81
+#define GRID_NIBBLES            41
+
+#define GRID_LANES              8
+#define GRID_VALID              0xFF    // first_unit of a grid that passes
+
+struct GridTables {
+    u16 onehot[256];                    // digit -> its bit, 0 outside 1-9
+};
+
+constexpr GridTables build_grid_tables() {
+    GridTables t = {};
+    for (u32 d = 1; d <= 9; d++) t.onehot[d] = u16(1 << (d - 1));
+    return t;
+}
+
+constexpr GridTables grid_tables = build_grid_tables();
+
+// scalar, first unit (rows, cols, then boxes, as in UNIT_ROW/COL/BOX) that
+// isn't all different, GRID_VALID if none
+u8  check_grid(const u8* grid, u8 format);
+
+// pass gets bit g & 63 of word g >> 6 set for every valid grid, first_unit
+// (may be NULL) the offending unit of each grid. returns the valid count
+u32 check_grids(const u8* grids, u32 n_grids, u8 format, u64* pass, u8* first_unit);
+
+#endif
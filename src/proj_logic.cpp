@@ -0,0 +1,256 @@
+#include "proj_logic.h"
+
+
+// -- Stages
+// clears bits from a cell, 0 if that empties it
+u8 _logic_remove(SearchState* s, u8 idx, u16 bits, u32* removed) {
+    u16 hit = s->cells[idx] & bits;
+    if (!hit) return 1;
+    s->cells[idx] &= ~hit;
+    *removed += BIT_COUNT(hit);
+    return s->cells[idx] != 0;
+}
+
+u32 _logic_naked(SearchState* s, SolverStats* stats) {
+    u32 removed = 0;
+    STAT_TECH(stats, runs, STAT_TECH_NAKED, 1);
+    for (u8 i = 0; i < BOARD_SIZE; i++) {
+        if (s->placed[i]) continue;
+
+        u16 m = s->cells[i];
+        if (!m) return LOGIC_CONTRADICTION;
+        if (BIT_COUNT(m) != 1) continue;
+
+        s->placed[i] = 1;
+        s->n_placed++;
+        removed++;
+        STAT_TECH(stats, placements, STAT_TECH_NAKED, 1);
+
+        u32 before = removed;
+        for (u8 k = 0; k < N_PEERS; k++) {
+            if (!_logic_remove(s, CELL_PEERS(i)[k], m, &removed)) return LOGIC_CONTRADICTION;
+        }
+        STAT_TECH(stats, eliminations, STAT_TECH_NAKED, removed - before);
+    }
+    return removed;
+}
+
+u32 _logic_hidden(SearchState* s, SolverStats* stats) {
+    u32 removed = 0;
+    STAT_TECH(stats, runs, STAT_TECH_HIDDEN, 1);
+    for (u8 u = 0; u < N_UNITS; u++) {
+        const u8* cells = UNIT_CELLS(u);
+        u16 once  = 0;
+        u16 twice = 0;
+        for (u8 k = 0; k < BOARD_DIM; k++) {
+            u16 m = s->cells[cells[k]];
+            twice |= once & m;
+            once  |= m;
+        }
+        if (once != BOARD_ALL) return LOGIC_CONTRADICTION;
+
+        u16 hidden = once & ~twice;
+        for (u8 k = 0; k < BOARD_DIM && hidden; k++) {
+            u8  idx = cells[k];
+            u16 bit = s->cells[idx] & hidden;
+            if (!bit) continue;
+            hidden &= ~bit;
+
+            // two hidden digits in one cell
+            if (BIT_COUNT(bit) > 1) return LOGIC_CONTRADICTION;
+            if (s->cells[idx] == bit) continue;
+
+            u32 before = removed;
+            _logic_remove(s, idx, ~bit, &removed);
+            STAT_TECH(stats, eliminations, STAT_TECH_HIDDEN, removed - before);
+            STAT_TECH(stats, placements,   STAT_TECH_HIDDEN, 1);
+        }
+    }
+    return removed;
+}
+
+/*
+    pointing: a digit confined to one row (col) of a box leaves the rest of
+    that row (col). claiming: a digit confined to one box of a row (col)
+    leaves the rest of that box. both compare the candidates of three
+    segments, the lines of a box or the boxes of a line.
+*/
+u32 _logic_box_line(SearchState* s, SolverStats* stats) {
+    u32 removed = 0;
+    STAT_TECH(stats, runs, STAT_TECH_BOX_LINE, 1);
+
+    for (u8 b = 0; b < BOARD_DIM; b++) {
+        const u8* box = UNIT_CELLS(UNIT_BOX(b));
+        u16 rows[3] = {0};
+        u16 cols[3] = {0};
+        for (u8 k = 0; k < BOARD_DIM; k++) {
+            rows[k / 3] |= s->cells[box[k]];
+            cols[k % 3] |= s->cells[box[k]];
+        }
+
+        for (u8 r = 0; r < 3; r++) {
+            u16 only_row = rows[r] & ~(rows[(r + 1) % 3] | rows[(r + 2) % 3]);
+            u16 only_col = cols[r] & ~(cols[(r + 1) % 3] | cols[(r + 2) % 3]);
+            for (u8 k = 0; k < BOARD_DIM && (only_row | only_col); k++) {
+                u8 row = UNIT_CELLS(UNIT_ROW(board_tables.row[box[r*3]]))[k];
+                u8 col = UNIT_CELLS(UNIT_COL(board_tables.col[box[r]]))[k];
+                if (only_row && board_tables.box[row] != b && !_logic_remove(s, row, only_row, &removed)) return LOGIC_CONTRADICTION;
+                if (only_col && board_tables.box[col] != b && !_logic_remove(s, col, only_col, &removed)) return LOGIC_CONTRADICTION;
+            }
+        }
+    }
+
+    for (u8 u = 0; u < 2 * BOARD_DIM; u++) {
+        const u8* line = UNIT_CELLS(u);
+        u16 segs[3] = {0};
+        for (u8 k = 0; k < BOARD_DIM; k++) segs[k / 3] |= s->cells[line[k]];
+
+        for (u8 g = 0; g < 3; g++) {
+            u16 only = segs[g] & ~(segs[(g + 1) % 3] | segs[(g + 2) % 3]);
+            if (!only) continue;
+
+            u8 b = board_tables.box[line[g * 3]];
+            const u8* box = UNIT_CELLS(UNIT_BOX(b));
+            for (u8 k = 0; k < BOARD_DIM; k++) {
+                u8 in_line = (u < BOARD_DIM) ? board_tables.row[box[k]] == u : board_tables.col[box[k]] == u - BOARD_DIM;
+                if (!in_line && !_logic_remove(s, box[k], only, &removed)) return LOGIC_CONTRADICTION;
+            }
+        }
+    }
+
+    STAT_TECH(stats, eliminations, STAT_TECH_BOX_LINE, removed);
+    return removed;
+}
+
+// n cells of a unit holding n digits between them, the rest of the unit loses those
+u32 _logic_subsets(SearchState* s, SolverStats* stats) {
+    u32 removed = 0;
+    STAT_TECH(stats, runs, STAT_TECH_SUBSET, 1);
+
+    for (u8 u = 0; u < N_UNITS; u++) {
+        const u8* cells = UNIT_CELLS(u);
+
+        // the open cells small enough to be part of a pair or triple
+        u8 small[BOARD_DIM];
+        u8 n_small = 0;
+        for (u8 k = 0; k < BOARD_DIM; k++) {
+            u8 count = BIT_COUNT(s->cells[cells[k]]);
+            if (!s->placed[cells[k]] && count >= 2 && count <= 3) small[n_small++] = cells[k];
+        }
+
+        for (u8 a = 0; a < n_small; a++) {
+            for (u8 b = a + 1; b < n_small; b++) {
+                for (u8 c = b + 1; c <= n_small; c++) {
+                    // c == n_small stands for the pair a, b on its own
+                    u8  pair  = c == n_small;
+                    u16 digits = s->cells[small[a]] | s->cells[small[b]] | (pair ? 0 : s->cells[small[c]]);
+                    if (BIT_COUNT(digits) != 3u - pair) continue;
+
+                    for (u8 k = 0; k < BOARD_DIM; k++) {
+                        u8 idx = cells[k];
+                        if (idx == small[a] || idx == small[b] || (!pair && idx == small[c])) continue;
+                        if (!_logic_remove(s, idx, digits, &removed)) return LOGIC_CONTRADICTION;
+                    }
+                }
+            }
+        }
+    }
+
+    STAT_TECH(stats, eliminations, STAT_TECH_SUBSET, removed);
+    return removed;
+}
+
+typedef u32 (*LogicStageFn)(SearchState* s, SolverStats* stats);
+
+LogicStageFn logic_stages[N_LOGIC_STAGES] = {_logic_naked, _logic_hidden, _logic_box_line, _logic_subsets};
+
+
+
+// -- Pipeline
+void logic_init(LogicPipeline* p, u8 deterministic) {
+    memset(p->stages, 0, sizeof(p->stages));
+    memset(p->steps, 0, sizeof(p->steps));
+    for (u8 i = 0; i < N_LOGIC_STAGES; i++) p->order[i] = i;
+    p->deterministic = deterministic;
+    p->runs          = 0;
+    p->used          = 0;
+}
+
+// removals per tick, best first. an untimed stage goes to the front to get measured
+void _logic_reorder(LogicPipeline* p) {
+    f64 yield[N_LOGIC_STAGES];
+    for (u8 i = 0; i < N_LOGIC_STAGES; i++) {
+        LogicStage* st = &p->stages[i];
+        yield[i] = st->ticks ? f64(st->removed) / f64(st->ticks) : 1e30;
+    }
+
+    for (u8 i = 1; i < N_LOGIC_STAGES; i++) {
+        u8 v = p->order[i];
+        u8 j = i;
+        for (; j > 0 && yield[p->order[j - 1]] < yield[v]; j--) p->order[j] = p->order[j - 1];
+        p->order[j] = v;
+    }
+}
+
+u8 logic_solve(SearchState* s, LogicPipeline* p, SolverStats* stats) {
+    STAT_BEGIN(stats, STAT_STAGE_LOGIC);
+    u8 ok = 1;
+    p->used = 0;
+    memset(p->steps, 0, sizeof(p->steps));
+
+    u8 k = 0;
+    while (k < N_LOGIC_STAGES && s->n_placed < BOARD_SIZE) {
+        u8  stage = p->order[k];
+        u64 start = p->deterministic ? 0 : stats_ticks();
+        u32 removed = logic_stages[stage](s, stats);
+        if (!p->deterministic) {
+            p->stages[stage].ticks += stats_ticks() - start;
+            p->stages[stage].calls++;
+            p->stages[stage].removed += (removed == LOGIC_CONTRADICTION) ? 0 : removed;
+        }
+
+        if (removed == LOGIC_CONTRADICTION) { ok = 0; break; }
+        if (removed) { p->used |= 1 << stage; p->steps[stage]++; k = 0; }
+        else k++;
+    }
+    s->hash = search_hash(s);
+
+    // adapt to the recent puzzles only
+    p->runs++;
+    if (!p->deterministic && p->runs % LOGIC_REORDER == 0) _logic_reorder(p);
+    if (!p->deterministic && p->runs % LOGIC_DECAY == 0) {
+        for (u8 i = 0; i < N_LOGIC_STAGES; i++) {
+            p->stages[i].calls   >>= 1;
+            p->stages[i].removed >>= 1;
+            p->stages[i].ticks   >>= 1;
+        }
+    }
+
+    STAT_END(stats, STAT_STAGE_LOGIC);
+    return ok;
+}
+
+u8 logic_solve_board(u16* board, LogicPipeline* p, SolverStats* stats) {
+    SearchState s;
+    search_load(&s, board);
+    if (!logic_solve(&s, p, stats) || s.n_placed != BOARD_SIZE) return 0;
+
+    for (u8 i = 0; i < BOARD_SIZE; i++) {
+        if (board[i] & BOARD_FLAG_STATIC) continue;
+        board[i] = (board[i] & BOARD_FLAGS & ~u16(BOARD_FLAG_PENCIL)) | s.cells[i];
+    }
+    return 1;
+}
+
+
+
+// -- Rating
+u32 logic_rate(u16* board, LogicPipeline* p, SolverStats* stats) {
+    SearchState s;
+    search_load(&s, board);
+    if (!logic_solve(&s, p, stats) || s.n_placed != BOARD_SIZE) return LOGIC_UNRATED;
+
+    u32 score = 0;
+    for (u8 i = 0; i < N_LOGIC_STAGES; i++) score += p->steps[i] * logic_weights[i];
+    return score;
+}
@@ -0,0 +1,85 @@
+#ifndef PROJ_LOGIC_H
+#define PROJ_LOGIC_H
+
+// local
+#include "proj_types.h"
+#include "proj_board.h"
+#include "proj_solver.h"
+#include "proj_stats.h"
+
+// system
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+
+
+/*
+    technique pipeline
+
+    the logical techniques run as stages on a SearchState. whenever a stage
+    makes progress the pipeline starts over from its first stage, and it
+    stops once the grid is placed or no stage gets anywhere. the deductions
+    only ever remove candidates, so the order changes how fast that point
+    is reached, never what it is.
+
+    an adaptive pipeline times every stage and keeps decaying counts of
+    what it removed, and reorders itself by removals per tick every
+    LOGIC_REORDER runs. a stage that rarely pays for itself sinks to the
+    end and is only reached once the cheap ones stall, which on easy
+    puzzles is never. a deterministic pipeline keeps the cost order below
+    and takes no timings, so which stages fire is reproducible (ratings
+    depend on that).
+*/
+#define LOGIC_NAKED             0   // naked singles
+#define LOGIC_HIDDEN            1   // hidden singles
+#define LOGIC_BOX_LINE          2   // pointing and claiming, the square rule both ways
+#define LOGIC_SUBSETS           3   // naked pairs and triples
+
+#define N_LOGIC_STAGES          4
+
+#define LOGIC_REORDER           64      // runs between reorders
+#define LOGIC_DECAY             1024    // runs between halving the counts
+
+#define LOGIC_CONTRADICTION     0xFFFFFFFF
+
+struct LogicStage {
+    u64 calls;
+    u64 removed;            // candidates removed plus cells placed
+    u64 ticks;
+};
+
+struct LogicPipeline {
+    u8         order[N_LOGIC_STAGES];
+    LogicStage stages[N_LOGIC_STAGES];
+    u8         deterministic = 1;
+    u32        runs          = 0;
+    u8         used          = 0;       // stages that fired during the last run, bit per stage
+    u16        steps[N_LOGIC_STAGES];   // times each stage made progress during the last run
+};
+
+void logic_init(LogicPipeline* p, u8 deterministic);
+
+// 0 on a contradiction, the grid is solved once s->n_placed == BOARD_SIZE
+u8   logic_solve(SearchState* s, LogicPipeline* p, SolverStats* stats);
+
+// logic_solve on a board, the solution is written back if it got there
+u8   logic_solve_board(u16* board, LogicPipeline* p, SolverStats* stats);
+
+
+/*
+    rating
+
+    a puzzle is rated by the deterministic pipeline. every step a stage
+    makes adds its weight, so the score grows both with how hard the
+    techniques are and with how often the solve has to fall back on them.
+    a puzzle the stages can't finish is unrated, anything they do finish
+    has exactly one solution.
+*/
+#define LOGIC_UNRATED           0xFFFFFFFF
+
+constexpr u32 logic_weights[N_LOGIC_STAGES] = {1, 2, 10, 40};
+
+u32  logic_rate(u16* board, LogicPipeline* p, SolverStats* stats);
+
+#endif
@@ -0,0 +1,293 @@
+#include "proj_lowclue.h"
+
+
+// -- Sets
+// marks set in the hit lists of its cells
+void _lowclue_hits(LowClueWorker* w, u32 set) {
+    u64 bit = 1ull << (set & 63);
+    for (u8 k = 0; k < 2; k++) {
+        u64 m = w->ua.masks[set][k];
+        while (m) {
+            w->hits[k*64 + mask_first(m)][set >> 6] |= bit;
+            m &= m - 1;
+        }
+    }
+}
+
+// 1 if the clues so far are a puzzle. if not, the cells the second
+// solution changes become a new set, unhit at every depth up to this one
+u8 _lowclue_check(LowClueWorker* w, u8 depth) {
+    LowClueResult* r = w->result;
+
+    u16 board[BOARD_SIZE];
+    memset(board, 0, sizeof(board));
+    for (u8 k = 0; k < depth; k++) {
+        u8 idx = w->clues[k];
+        board[idx] = BOARD_FLAG_STATIC | (1 << (w->grid[idx] - 1));
+    }
+
+    solver_load(&w->ctx, board);
+    r->checks++;
+    if (solver_count(&w->ctx, 2, &w->stats) == 1) {
+        u8* puzzle = r->puzzles[r->n_found++];
+        for (u8 i = 0; i < BOARD_SIZE; i++) puzzle[i] = board[i] ? w->grid[i] : 0;
+        return 1;
+    }
+
+    // the count stops on the second solution, one of the two isn't the grid
+    u8 other[BOARD_SIZE];
+    memcpy(other, w->ctx.digits, BOARD_SIZE);
+    if (!memcmp(other, w->grid, BOARD_SIZE)) {
+        for (u8 i = 0; i < BOARD_SIZE; i++) other[i] = BIT_DIGIT(w->ctx.state.cells[i]);
+    }
+
+    // once the list is full the largest set makes room, the new one holds
+    // no clue so far so it's unhit at every depth either way
+    Unavoidables* ua  = &w->ua;
+    u32           set = ua->n_sets;
+    if (set == UA_MAX_SETS) {
+        set = 0;
+        for (u32 i = 1; i < ua->n_sets; i++) {
+            if (ua->sizes[i] > ua->sizes[set]) set = i;
+        }
+        for (u8 i = 0; i < BOARD_SIZE; i++) w->hits[i][set >> 6] &= ~(1ull << (set & 63));
+    } else {
+        ua->n_sets++;
+    }
+
+    ua_diff(w->grid, other, ua->masks[set]);
+    ua->sizes[set] = mask_count(ua->masks[set][0]) + mask_count(ua->masks[set][1]);
+    _lowclue_hits(w, set);
+    for (u8 d = 0; d <= depth; d++) w->unhit[d][set >> 6] |= 1ull << (set & 63);
+    r->learned++;
+    return 0;
+}
+
+void _lowclue_search(LowClueWorker* w, u8 depth) {
+    LowClueResult* r = w->result;
+    if (r->nodes >= w->budget || r->n_found == LOWCLUE_MAX_FOUND) return;
+    r->nodes++;
+
+    u64* unhit = w->unhit[depth];
+    u64  any   = 0;
+    for (u8 k = 0; k < UA_WORDS; k++) any |= unhit[k];
+    if (!any) {
+        if (_lowclue_check(w, depth)) return;
+        for (u8 k = 0; k < UA_WORDS; k++) any |= unhit[k];
+        if (!any) return;
+    }
+    if (depth == w->target) return;
+
+    // the unhit set with the fewest live cells to branch on, and the
+    // disjoint unhit sets as a bound on the clues still needed
+    const u64* dead      = w->dead;
+    u32        best      = 0;
+    u8         best_live = 0xFF;
+    u64        used[2]   = {0, 0};
+    u8         disjoint  = 0;
+    for (u8 k = 0; k < UA_WORDS; k++) {
+        u64 m = unhit[k];
+        while (m) {
+            u32 set = k*64 + mask_first(m);
+            m &= m - 1;
+
+            const u64* mask = w->ua.masks[set];
+            u8 live = mask_count(mask[0] & ~dead[0]) + mask_count(mask[1] & ~dead[1]);
+            if (!live) return;
+            if (live < best_live) {
+                best      = set;
+                best_live = live;
+            }
+            if (!(mask[0] & used[0]) && !(mask[1] & used[1])) {
+                used[0] |= mask[0];
+                used[1] |= mask[1];
+                disjoint++;
+            }
+        }
+    }
+    if (disjoint > w->target - depth) return;
+
+    u64 live[2]   = {w->ua.masks[best][0] & ~dead[0], w->ua.masks[best][1] & ~dead[1]};
+    u64 killed[2] = {0, 0};
+    for (u8 h = 0; h < 2; h++) {
+        while (live[h]) {
+            u8  idx = h*64 + mask_first(live[h]);
+            u64 bit = live[h] & (0 - live[h]);
+            live[h] &= live[h] - 1;
+
+            // a set learned below is unhit here too, so read unhit again
+            w->clues[depth] = idx;
+            for (u8 k = 0; k < UA_WORDS; k++) w->unhit[depth + 1][k] = unhit[k] & ~w->hits[idx][k];
+            _lowclue_search(w, depth + 1);
+
+            w->dead[h] |= bit;
+            killed[h]  |= bit;
+        }
+    }
+    w->dead[0] &= ~killed[0];
+    w->dead[1] &= ~killed[1];
+}
+
+u32 lowclue_grid(LowClueWorker* w, const u8* grid, u8 target, u64 node_budget, LowClueResult* out) {
+    memset(out, 0, sizeof(*out));
+    w->grid   = grid;
+    w->target = target;
+    w->budget = node_budget;
+    w->result = out;
+
+    ua_find(grid, &w->ua, UA_MAX_DIGITS);
+    memset(w->hits,  0, sizeof(w->hits));
+    memset(w->unhit, 0, sizeof(w->unhit));
+    for (u32 i = 0; i < w->ua.n_sets; i++) {
+        _lowclue_hits(w, i);
+        w->unhit[0][i >> 6] |= 1ull << (i & 63);
+    }
+    w->dead[0] = 0;
+    w->dead[1] = 0;
+
+    _lowclue_search(w, 0);
+    return out->n_found;
+}
+
+
+
+// -- Checkpoint
+u8 lowclue_load(LowClueSearch* s) {
+    FILE* file = fopen(s->checkpoint, "r");
+    if (!file) return 0;
+
+    char key[32];
+    u64  value;
+    while (fscanf(file, "%31s %llu", key, &value) == 2) {
+        if      (!strcmp(key, "clues"))       s->clues       = u8(value);
+        else if (!strcmp(key, "seed"))        s->seed        = value;
+        else if (!strcmp(key, "node_budget")) s->node_budget = value;
+        else if (!strcmp(key, "batches"))     s->batches     = value;
+        else if (!strcmp(key, "grids"))       s->grids       = value;
+        else if (!strcmp(key, "nodes"))       s->nodes       = value;
+        else if (!strcmp(key, "checks"))      s->checks      = value;
+        else if (!strcmp(key, "found"))       s->found       = value;
+        else if (!strcmp(key, "output_bytes")) s->output_bytes = value;
+    }
+    fclose(file);
+    return 1;
+}
+
+// written aside and moved over the old one, a kill never leaves half a checkpoint
+u8 lowclue_save(LowClueSearch* s) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s.tmp", s->checkpoint);
+
+    FILE* file = fopen(path, "w");
+    if (!file) return 0;
+    fprintf(file, "clues %u\n",       s->clues);
+    fprintf(file, "seed %llu\n",      s->seed);
+    fprintf(file, "node_budget %llu\n", s->node_budget);
+    fprintf(file, "batches %llu\n",   s->batches);
+    fprintf(file, "grids %llu\n",     s->grids);
+    fprintf(file, "nodes %llu\n",     s->nodes);
+    fprintf(file, "checks %llu\n",    s->checks);
+    fprintf(file, "found %llu\n",     s->found);
+    fprintf(file, "output_bytes %llu\n", s->output_bytes);
+    fclose(file);
+
+    return MoveFileExA(path, s->checkpoint, MOVEFILE_REPLACE_EXISTING) != 0;
+}
+
+
+
+// -- Batches
+// the output back to where the checkpoint left it, or where it is now on a
+// new search (or a checkpoint from before the length was kept)
+void _lowclue_trim(LowClueSearch* s) {
+    HANDLE file = CreateFileA(s->output, GENERIC_WRITE, 0, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return;
+
+    LARGE_INTEGER size;
+    if (GetFileSizeEx(file, &size)) {
+        if (s->output_bytes == LOWCLUE_UNKNOWN || u64(size.QuadPart) < s->output_bytes) {
+            s->output_bytes = u64(size.QuadPart);
+        } else if (u64(size.QuadPart) > s->output_bytes) {
+            LARGE_INTEGER keep;
+            keep.QuadPart = LONGLONG(s->output_bytes);
+            SetFilePointerEx(file, keep, NULL, FILE_BEGIN);
+            SetEndOfFile(file);
+            printf("[LowClue] dropped %llu bytes a stopped batch appended to %s\n", u64(size.QuadPart) - s->output_bytes, s->output);
+        }
+    }
+    CloseHandle(file);
+}
+
+void _lowclue_task(void* args, u32 index, u32 worker) {
+    LowClueSearch* s = (LowClueSearch*) args;
+    lowclue_grid(&s->workers[worker], s->batch + u64(index) * BOARD_SIZE, s->clues, s->node_budget, &s->results[index]);
+}
+
+void lowclue_run(LowClueSearch* s, ThreadPool* pool, u64 seconds) {
+    s->n_grids = LOWCLUE_BATCH;
+    s->batch   = (u8*)            malloc(u64(s->n_grids) * BOARD_SIZE);
+    s->results = (LowClueResult*) malloc(sizeof(LowClueResult) * s->n_grids);
+    s->workers = (LowClueWorker*) malloc(sizeof(LowClueWorker) * pool->n_threads);
+
+    tt_init(&s->table, LOWCLUE_TT_BUCKETS, 0);
+    stats_reset(&s->stats);
+    for (u32 t = 0; t < pool->n_threads; t++) {
+        s->workers[t].ctx.tt = &s->table;
+        stats_reset(&s->workers[t].stats);
+    }
+
+    _lowclue_trim(s);
+
+    u64 start = stats_ticks();
+    while (!seconds || stats_ticks_to_ns(stats_ticks() - start) < seconds * 1000000000ull) {
+        // grids come from the batch number, a resumed search makes the same ones
+        u64 batch_start = stats_ticks();
+        Rng rng;
+        rng_seed(&rng, s->seed, s->batches);
+        for (u32 g = 0; g < s->n_grids; g++) generate_grid(s->batch + u64(g) * BOARD_SIZE, &rng);
+
+        pool_run(pool, _lowclue_task, s, s->n_grids);
+        for (u32 t = 0; t < pool->n_threads; t++) {
+            stats_merge(&s->stats, &s->workers[t].stats);
+            stats_reset(&s->workers[t].stats);
+        }
+
+        u64 nodes = 0;
+        FILE* file = fopen(s->output, "a");
+        for (u32 g = 0; g < s->n_grids; g++) {
+            LowClueResult* r = &s->results[g];
+            for (u32 p = 0; p < r->n_found && file; p++) {
+                char line[BOARD_SIZE + 2];
+                for (u8 i = 0; i < BOARD_SIZE; i++) line[i] = '0' + r->puzzles[p][i];
+                line[BOARD_SIZE]     = '\n';
+                line[BOARD_SIZE + 1] = 0;
+                fputs(line, file);
+            }
+            nodes     += r->nodes;
+            s->checks += r->checks;
+            s->found  += r->n_found;
+        }
+        if (file) {
+            fflush(file);
+            s->output_bytes = u64(_ftelli64(file));
+            fclose(file);
+        }
+
+        s->nodes += nodes;
+        s->grids += s->n_grids;
+        s->batches++;
+        lowclue_save(s);
+
+        f64 ms = f64(stats_ticks_to_ns(stats_ticks() - batch_start)) / 1e6;
+        printf("[LowClue] batch %llu :: %llu grids, %llu found (%u clues or fewer), %.0f knodes/s, tt hit rate %.3f\n",
+               s->batches, s->grids, s->found, s->clues, f64(nodes) / ms, tt_hit_rate(&s->table));
+#ifdef STATS_ENABLE
+        stats_print(&s->stats);
+#endif
+    }
+
+    tt_free(&s->table);
+    free(s->batch);
+    free(s->results);
+    free(s->workers);
+}
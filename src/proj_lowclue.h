@@ -0,0 +1,108 @@
+#ifndef PROJ_LOWCLUE_H
+#define PROJ_LOWCLUE_H
+
+// local
+#include "proj_types.h"
+#include "proj_board.h"
+#include "proj_solver.h"
+#include "proj_unavoid.h"
+#include "proj_pool.h"
+#include "proj_stats.h"
+
+// third party
+#include "windows.h"
+
+// system
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+
+
+/*
+    low clue search
+
+    a puzzle whose only solution is a grid gives a clue in every
+    unavoidable set of that grid, so looking for puzzles of n clues is
+    looking for hitting sets of n cells. each node takes the unhit set with
+    the fewest live cells and branches on those cells, a cell that has been
+    branched on is dead for the siblings after it so no clue set comes up
+    twice. a node is cut once more disjoint sets are unhit than clues are
+    left. when every known set is hit the clues go to the uniqueness
+    counter, and a second solution it turns up is one more set to hit.
+
+    grids are searched in batches over the pool, each grid with a node
+    budget. after every batch the puzzles found are appended to the output
+    file (one 81 character line each, 0 for an empty cell) and the
+    checkpoint is rewritten, so a search that gets stopped picks up at the
+    batch it was on. the checkpoint has the length of the output file as
+    of that batch, a resumed search cuts off whatever a stopped batch got
+    to append after it, so no puzzle is written twice. the uniqueness counts of every worker share a table,
+    and count into stats of the worker's own, merged after every batch.
+*/
+#define LOWCLUE_MAX_CLUES       24
+#define LOWCLUE_MAX_FOUND       16          // puzzles kept per grid
+#define LOWCLUE_NODE_BUDGET     (1 << 20)   // per grid
+#define LOWCLUE_BATCH           64          // grids per batch, the same on any core count
+#define LOWCLUE_TT_BUCKETS      16          // log2
+#define LOWCLUE_UNKNOWN         0xFFFFFFFFFFFFFFFFull
+
+struct LowClueResult {
+    u32 n_found;
+    u8  puzzles[LOWCLUE_MAX_FOUND][BOARD_SIZE];
+    u64 nodes;
+    u32 checks;                 // uniqueness counts
+    u32 learned;                // sets added from second solutions
+};
+
+struct LowClueWorker {
+    SolverContext  ctx;
+    SolverStats    stats;
+    Unavoidables   ua;
+    u64            hits[BOARD_SIZE][UA_WORDS];                  // sets holding each cell
+    u64            unhit[LOWCLUE_MAX_CLUES + 1][UA_WORDS];      // per depth
+    u64            dead[2];
+    u8             clues[LOWCLUE_MAX_CLUES];
+
+    const u8*      grid;
+    u8             target;
+    u64            budget;
+    LowClueResult* result;
+};
+
+struct LowClueSearch {
+    // settings, a checkpoint overrides them
+    u8          clues       = 20;
+    u64         seed        = 0;
+    u64         node_budget = LOWCLUE_NODE_BUDGET;
+    const char* output      = "lowclue.txt";
+    const char* checkpoint  = "lowclue.chk";
+
+    // progress, kept in the checkpoint
+    u64 batches = 0;
+    u64 grids   = 0;
+    u64 nodes   = 0;
+    u64 checks  = 0;
+    u64 found   = 0;
+    u64 output_bytes = LOWCLUE_UNKNOWN;     // the output file after the last batch
+
+    // per run, filled in with STATS_ENABLE
+    SolverStats    stats;
+    u32            n_grids  = 0;
+    u8*            batch    = NULL;
+    LowClueResult* results  = NULL;
+    LowClueWorker* workers  = NULL;
+    TransTable     table;
+};
+
+// puzzles of at most target clues with grid as their only solution, into out
+u32  lowclue_grid(LowClueWorker* w, const u8* grid, u8 target, u64 node_budget, LowClueResult* out);
+
+// 1 if s->checkpoint was there and read
+u8   lowclue_load(LowClueSearch* s);
+u8   lowclue_save(LowClueSearch* s);
+
+// batches until seconds have passed, 0 runs until the process is stopped
+void lowclue_run(LowClueSearch* s, ThreadPool* pool, u64 seconds);
+
+#endif
@@ -18,6 +18,12 @@ XXX
 #include "proj_types.h"
 #include "proj_math.h"
 #include "proj_sound.h"
+#include "proj_board.h"
+#include "proj_solver.h"
+#include "proj_logic.h"
+#include "proj_stats.h"
+#include "proj_verify.h"
+#include "proj_prefetch.h"
 
 // third party
 #include "windows.h"
@@ -275,31 +281,6 @@ static void scroll_callback(GLFWwindow* window, f64 xoffset, f64 yoffset) {
 
 
 
-#define BOARD_EMPTY        0x0000
-#define BOARD_1            0x0001
-#define BOARD_2            0x0002
-#define BOARD_3            0x0004
-#define BOARD_4            0x0008
-#define BOARD_5            0x0010
-#define BOARD_6            0x0020
-#define BOARD_7            0x0040
-#define BOARD_8            0x0080
-#define BOARD_9            0x0100
-#define BOARD_ALL          0x01FF
-
-#define BOARD_FLAG_PENCIL  0x8000
-#define BOARD_FLAG_ERROR   0x4000
-#define BOARD_FLAG_STATIC  0x2000
-#define BOARD_FLAG_CURSOR  0x1000
-#define BOARD_FLAG_HOVER   0x0800
-#define BOARD_FLAG_SOLVE   0x0400
-#define BOARD_FLAG_AI      0x0200
-#define BOARD_FLAGS        0xFE00
-
-#define BOARD_DIM        16
-#define BOARD_SIZE       (BOARD_DIM * BOARD_DIM)
-#define IDX(x,y)         ((u16(y)*BOARD_DIM) + (x))
-
 
 #define LIST_NULL    0x1
 #define LIST_ROOT    0x2
@@ -342,886 +323,6 @@ void list_free(ListItem* node) {
 }
 
 
-u8 _check(u16* board_data, u8 lx, u8 hx, u8 ly, u8 hy) {
-    u16 cache[9][9];
-    u8  indices[9];
-
-    // clear cache
-    for (u8 j = 0; j < 9; j++) {
-        indices[j] = 0;
-        for (u8 i = 0; i < 9; i++) {
-            cache[i][j] = 0;
-        }
-    }
-    
-    // record values
-    for (u8 j = ly; j < hy; j++) {
-        for (u8 i = lx; i < hx; i++) {
-            u16 idx = IDX(i, j);
-            for (u8 n = 0; n < 9; n++) {
-                if (board_data[idx] & (1<<n)) {
-                    cache[n][indices[n]] = idx;
-                    indices[n]++;
-                }
-            }
-        }
-    }
-
-    // check errors
-    u8 score = 0;
-    for (u8 n = 0; n < 9; n++) {
-        if (indices[n] < 2) {
-            if (indices[n] > 0) score++;
-            continue;
-        }
-
-        // count members statics
-        u8 entered_set = 0;
-        u8 static_set  = 0;
-        for (u8 i = 0; i < 9; i++) {
-            if (i >= indices[n]) break;
-            if (!(board_data[cache[n][i]] & BOARD_ALL)) continue;
-            if (!(board_data[cache[n][i]] & BOARD_FLAG_PENCIL)) entered_set++;
-            if   (board_data[cache[n][i]] & BOARD_FLAG_STATIC)  static_set++;
-        }
-        
-        // enter errors
-        for (u8 i = 0; i < 9; i++) {
-            if (i >= indices[n]) break;
-            if (board_data[cache[n][i]] & BOARD_FLAG_PENCIL) {
-                if (static_set > u8((board_data[cache[n][i]] & BOARD_FLAG_STATIC) != 0) ) {
-                    board_data[cache[n][i]] |= BOARD_FLAG_ERROR;
-                }
-            } else {
-                if ((entered_set + static_set) > 1) {
-                    board_data[cache[n][i]] |= BOARD_FLAG_ERROR;
-                }
-            }
-        }
-    }
-
-    return score;
-}
-
-u8 validate_board(u16* board_data) {
-    // clear errors and solves
-    for (u8 y = 0; y < 9; y++) {
-        for (u8 x = 0; x < 9; x++) {
-            board_data[IDX(x,y)] &= ~u16(BOARD_FLAG_ERROR | BOARD_FLAG_SOLVE);
-        }
-    }
-
-    // each check is worth 9
-    // - 9 square checks
-    // - 9 row checks
-    // - 9 col checks
-    // => success = 9 * 9 * 3
-    u32 score = 0;
-
-    // check squares
-    for (u8 square_y = 0; square_y < 3; square_y++) {
-        for (u8 square_x = 0; square_x < 3; square_x++) {
-            score += _check(board_data, square_x*3, (square_x+1)*3, square_y*3, (square_y+1)*3);
-        }
-    }
-
-    // check rows
-    for (u8 row = 0; row < 9; row++) {
-        score += _check(board_data, 0, 9, row, row+1);
-    }
-
-    // check cols
-    for (u8 col = 0; col < 9; col++) {
-        score += _check(board_data, col, col+1, 0, 9);
-    }
-
-    // solve check
-    if (score >= 9*9*3) {
-        for (u8 j = 0; j < 9; j++) {
-            for (u8 i = 0; i < 9; i++) {
-                if (!(board_data[IDX(i,j)] & BOARD_FLAG_STATIC)) {
-                    board_data[IDX(i,j)] &= ~u16(BOARD_FLAG_PENCIL);
-                    board_data[IDX(i,j)] |= BOARD_FLAG_SOLVE;
-                }
-            }
-        }
-        return 1;
-    }
-    return 0;
-}
-
-
-
-#define PROGRESS_DEFAULT        0   // no state change
-#define PROGRESS_STATE_CHANGE   1   // state change
-#define PROGRESS_INV_CELL       2   // invalid cell
-#define PROGRESS_SET_CELL       3   // cell solved
-#define PROGRESS_DEBUG          4   // exit
-
-u8 set_pencils(u16* board, u8 clear) {
-    u8 statics = 0;
-    u16 mask = BOARD_FLAG_PENCIL | BOARD_ALL;
-
-    // set non-statics to full pencils
-    for (u16 j = 0; j < 9; j++) {
-        for (u16 i = 0; i < 9; i++) {
-            u16 idx = IDX(i,j);
-            if (!(board[idx] & BOARD_FLAG_STATIC)) {
-                if (clear) {
-                    board[idx] |= mask;
-                } else if (!(board[idx] & BOARD_ALL) || (board[idx] & BOARD_FLAG_PENCIL)) {
-                    // set if there is only 1 bit set
-                    board[idx] |= mask;
-                }
-            } else statics++;
-        }
-    }
-
-    return statics != 81;
-}
-
-// compares cells to remove options
-u8 _deduce_cell(u16* base, u16* cmp, u16* all_cache, u16* set_cache) {
-    bool cell_static = *cmp & BOARD_FLAG_STATIC;
-    bool cell_pencil = *cmp & BOARD_FLAG_PENCIL;
-
-    *all_cache |= *cmp; /* cache all elements *except* the base element */
-
-    if (cell_static || !cell_pencil) {
-        *set_cache |= *cmp; /* cache all _set_ elements *except* base element */
-
-        u16 tmp = *base;
-        *base &= ~(*cmp & BOARD_ALL);
-        if ((tmp & BOARD_ALL) != (*base & BOARD_ALL)) {
-            return PROGRESS_STATE_CHANGE;
-        }
-    }
-
-    return PROGRESS_DEFAULT;
-}
-
-// solidifies options
-u8 _ink_cell(u16* base, u16 all_cache) {\
-    all_cache &= BOARD_ALL;
-
-    u16 check = *base & BOARD_ALL;
-    if (check && !(check & (check-1))) {
-        /*
-           0000 0000 0010 0000 :: check :: we have only 1 option
-           0000 0000 0001 1111 :: check - 1
-           0000 0000 0000 0000 :: check & (check-1)
-           0000 0000 0000 0001 :: !(check & (check-1))
-
-           0000 0000 1111 0000 :: check :: we have multiple options
-           0000 0000 1110 1111 :: check - 1
-           0000 0000 1110 0000 :: check & (check-1)
-           0000 0000 0000 0000 :: !(check & (check-1))
-        */
-        *base &= ~u16(BOARD_FLAG_PENCIL);
-        return PROGRESS_SET_CELL;
-    }
-    
-    if (all_cache < BOARD_ALL) {
-        /*
-           0000 0001 1011 1111 :: cache :: no 7's in the square/row/col
-           0000 0000 1111 0000 :: board :: we can put our 7 down
-           
-           0000 0000 1011 0000 :: board & cache
-           0000 0000 0100 0000 :: board ^ (board & cache)
-        */
-        check = *base ^ (*base & all_cache);
-        if (check & BOARD_ALL) {
-            *base &= check | BOARD_FLAGS;
-            *base &= ~u16(BOARD_FLAG_PENCIL);
-            return PROGRESS_SET_CELL;
-        }
-    }
-
-    return PROGRESS_DEFAULT;
-}
-
-u8 _solve_square(u16* board, u16 base_idx, u16 base_x, u16 base_y, u8 square_rule) {
-    #define R(i)   sq_cache[0+i]
-    #define C(i)   sq_cache[3+i]
-    u16 sq_cache[6]; // caches 3 rows + 3 cols
-    for (u8 i = 0; i < 6; i++) sq_cache[i] = 0;
-
-    // local square coords
-    u16 n[2];
-    n[0] = base_y % 3;
-    n[1] = base_x % 3;
-
-    u8 state_change = PROGRESS_DEFAULT;
-
-    u8  result;
-    u16 all_cache = 0;
-    u16 set_cache = 0;
-
-    for (u16 cmp_y = 0; cmp_y < 3; cmp_y++) {
-        for (u16 cmp_x = 0; cmp_x < 3; cmp_x++) {
-            u16 cmp_inner_x = (base_x/3)*3+cmp_x;
-            u16 cmp_inner_y = (base_y/3)*3+cmp_y;
-            u16 cmp_idx = IDX(cmp_inner_x, cmp_inner_y);
-            if (cmp_idx == base_idx) continue;
-
-            result = _deduce_cell(&board[base_idx], &board[cmp_idx], &all_cache, &set_cache);
-            if (result == PROGRESS_STATE_CHANGE) state_change = result;
-
-            // cache element options
-            u16 pencil = (board[cmp_idx] & BOARD_FLAG_PENCIL) > 0;
-            u16 digits = pencil * (board[cmp_idx] & BOARD_ALL);
-            R(cmp_y) |= digits;
-            C(cmp_x) |= digits;
-        }
-    }
-    set_cache &= BOARD_ALL;
-
-    // cache base cell
-    u16 digits = board[base_idx] & BOARD_ALL;
-    R(n[0]) |= digits;
-    C(n[1]) |= digits;
-
-    u16 q;
-    u16 lower, upper;
-
-    /*
-        -- determine if this is a row or column application
-
-                                            9 9                            
-                                            v v                            
-                                           +-----+                         
-                   3 7 8            7, 8 > |3 * *| ---> 7, 8 --->          
-                   5 1 2    =>             |5 1 2|                         
-                   9 6 4             3*  > |* 6 4|                        3* to indicate lingering option 
-                                           +-----+                         
-           0000 0000 0011 1111 :: set
-
-           0000 0001 1100 0000 :: r1    0000 0000 1100 0000 :: q1 = r1 & ~(r2 | r3 | set)   -- Get pencil numbers exclusive to this row
-           0000 0000 0000 0000 :: r2    0000 0000 0000 0000 :: q2 = r2 & ~(r1 | r3 | set)          
-           0000 0001 0000 0100 :: r3    0000 0000 0000 0000 :: q3 = r3 & ~(r1 | r2 | set)          
-
-           0000 0001 0000 0100 :: c1    0000 0000 0000 0000 :: q1 = c1 & ~(c2 | c3 | set)   -- Get pencil numbers exclusive to this col
-           0000 0001 1100 0000 :: c2    0000 0000 0000 0000 :: q2 = c2 & ~(c1 | c3 | set)                                        
-           0000 0000 1100 0000 :: c3    0000 0000 0000 0000 :: q3 = c3 & ~(c1 | c2 | set)                                        
-    */
-
-    if (square_rule) {
-        // skip the current square
-        lower  = base_x/3;
-        upper  = (lower + 1) * 3;
-        lower *= 3;
-
-        // propagate removals through rows
-        q = R(n[0]) & ~(R(0)*u16(n[0]!=0) | 
-                        R(1)*u16(n[0]!=1) | 
-                        R(2)*u16(n[0]!=2) | set_cache);
-
-        for (u16 i = 0; i < 9 * u16(q>0); i++) {
-            if (i >= lower && i < upper) continue;
-            u16 idx = IDX(i, (base_y/3)*3+n[0]);
-            if (board[idx] & BOARD_FLAG_PENCIL) board[idx] &= ~q;
-        }
-    }
-
-    if (square_rule) {
-        // skip the current square
-        lower  = base_y/3;
-        upper  = (lower + 1) * 3;
-        lower *= 3;
-
-        // propagate removals through cols
-        q = C(n[1]) & ~(C(0)*u16(n[1]!=0) | 
-                        C(1)*u16(n[1]!=1) | 
-                        C(2)*u16(n[1]!=2) | set_cache);
-
-        for (u16 i = 0; i < 9 * u16(q>0); i++) {
-            if (i >= lower && i < upper) continue;
-            u16 idx = IDX((base_x/3)*3+n[1], i);
-            if (board[idx] & BOARD_FLAG_PENCIL) board[idx] &= ~q;
-        }
-    }
-
-    #undef R
-    #undef C
-
-    result = _ink_cell(&board[base_idx], all_cache);
-    if (result == PROGRESS_SET_CELL) state_change = result;
-    return state_change;
-}
-
-u8 _solve_row(u16* board, u16 base_idx, u16 base_y) {
-    u8 state_change = PROGRESS_DEFAULT;
-
-    u8  result;
-    u16 all_cache = 0;
-    u16 set_cache = 0;
-
-    // remove possible options from cell
-    for (u16 cmp_x = 0; cmp_x < 9; cmp_x++) {
-        u16 cmp_idx = IDX(cmp_x, base_y);
-        if (cmp_idx == base_idx) continue;
-        result = _deduce_cell(&board[base_idx], &board[cmp_idx], &all_cache, &set_cache);
-        if (result == PROGRESS_STATE_CHANGE) state_change = result;
-    }
-
-    // set cell if possible
-    result = _ink_cell(&board[base_idx], all_cache);
-    if (result == PROGRESS_SET_CELL) state_change = result;
-
-    // clear row
-    if (state_change == PROGRESS_SET_CELL) {
-        u16 digit = board[base_idx] & BOARD_ALL;
-        for (u16 i = 0; i < 9; i++) {
-            u16 idx = IDX(i, base_y);
-            if (board[idx] & BOARD_FLAG_PENCIL) board[idx] &= ~digit;
-        }
-        board[base_idx] |= digit;
-    }
-
-    return state_change;
-}
-
-u8 _solve_col(u16* board, u16 base_idx, u16 base_x) {
-    u8 state_change = PROGRESS_DEFAULT;
-
-    u8  result;
-    u16 all_cache = 0;
-    u16 set_cache = 0;
-
-    // remove possible options from cell
-    for (u16 cmp_y = 0; cmp_y < 9; cmp_y++) {
-        u16 cmp_idx = IDX(base_x, cmp_y);
-        if (cmp_idx == base_idx) continue;
-        result = _deduce_cell(&board[base_idx], &board[cmp_idx], &all_cache, &set_cache);
-        if (result == PROGRESS_STATE_CHANGE) state_change = result;
-    }
-
-    // set cell if possible
-    result = _ink_cell(&board[base_idx], all_cache);
-    if (result == PROGRESS_SET_CELL) state_change = result;
-
-    // clear col
-    if (state_change == PROGRESS_SET_CELL) {
-        u16 digit = board[base_idx] & BOARD_ALL;
-        for (u16 i = 0; i < 9; i++) {
-            u16 idx = IDX(base_x, i);
-            if (board[idx] & BOARD_FLAG_PENCIL) board[idx] &= ~digit;
-        }
-        board[base_idx] |= digit;
-    }
-
-    return state_change;
-}
-
-
-// NOTE: this procedure is aesthetics > function
-u8 make_progress(u16* board, u8 base_x, u8 base_y, u8 stage, u8 square_rule) {
-    // skip statics and already set cells
-    u16 base_idx = IDX(base_x, base_y);
-    {
-        bool cell_static = board[base_idx] & BOARD_FLAG_STATIC;
-        bool cell_pencil = board[base_idx] & BOARD_FLAG_PENCIL;
-        if (cell_static || !cell_pencil) return PROGRESS_INV_CELL;
-    }
-
-    if (stage == 0) return _solve_square(board, base_idx, base_x, base_y, square_rule);
-    if (stage == 1) return _solve_row(board, base_idx, base_y);
-    if (stage == 2) return _solve_col(board, base_idx, base_x);
-
-    return PROGRESS_DEFAULT;
-}
-
-
-/*
-FIXME
-implement tree search for something like this,
-
-300200000
-000107000
-706030500
-070009080
-900020004
-010800050
-009040301
-000702000
-000008006
-*/
-
-#define CACHE_REGION() {\
-    u8 flag = 0;\
-    flag |= (board[indices[n]] & BOARD_FLAG_STATIC) != 0;\
-    flag |= (board[indices[n]] & BOARD_FLAG_PENCIL) == 0;\
-    if (flag) {\
-        statics |= board[indices[n]];\
-    }\
-    \
-    /* cache region */\
-    for (u8 i = 0; i < 9; i++) {\
-        if (n == i) continue;\
-        if (!n) caches[i] = 0;\
-        caches[i] |= board[indices[n]];\
-    }\
-}
-
-
-#define UPDATE_REGION() {\
-    statics &= BOARD_ALL;\
-    while (statics < BOARD_ALL) {\
-        u8 set = 0;\
-        for (u8 x = 0; x < 9; x++) {\
-            if (board[indices[x]] & BOARD_FLAG_PENCIL) {\
-                /* update pencil options */ \
-                board[indices[x]] &= ~statics;\
-                \
-                /* ink */ \
-                u16 check = board[indices[x]] & BOARD_ALL;\
-                if (check && !(check & (check-1))) {\
-                    board[indices[x]] &= ~u16(BOARD_FLAG_PENCIL);\
-                    statics |= check;\
-                    set = 1;\
-                } else {\
-                    u16 changed = check ^ (check & caches[x] & BOARD_ALL);\
-                    if (changed) {\
-                        board[indices[x]] &= changed | BOARD_FLAGS;\
-                        board[indices[x]] &= ~u16(BOARD_FLAG_PENCIL);\
-                        statics |= changed;\
-                        set = 1;\
-                    }\
-                }\
-            }\
-        }\
-        if (!set) break;\
-    }\
-}
-
-
-u8 fast_solve(u16* board) {
-    u8  solved = 0;
-
-    u16 indices[9];
-    u16 caches[9];
-    u16 statics;
-
-    // rows
-    for (u8 y = 0; y < 9; y++) {
-        statics = 0;
-
-        // grab statics
-        for (u8 x = 0; x < 9; x++) {
-            u8 n = x;
-            indices[n] = IDX(x,y);
-            CACHE_REGION();
-        }
-
-        UPDATE_REGION();
-        if (statics == BOARD_ALL) solved++;
-    }
-
-
-    // squares -- TODO should add the square rule here
-    for (u8 cy = 0; cy < 9; cy += 3) {
-        for (u8 cx = 0; cx < 9; cx += 3) {
-            statics = 0;
-
-            // grab statics
-            for (u8 y = 0; y < 3; y++) {
-                for (u8 x = 0; x < 3; x++) {
-                    u8 n = y*3 + x;
-                    indices[n] = IDX( (cx+x), (cy+y) );
-                    CACHE_REGION();
-                }
-            }
-
-            UPDATE_REGION();
-            if (statics == BOARD_ALL) solved++;
-        }
-    }
-
-
-    // cols
-    for (u8 y = 0; y < 9; y++) {
-        statics = 0;
-
-        // grab statics
-        for (u8 x = 0; x < 9; x++) {
-            u8 n = x;
-            indices[n] = IDX(y,x);
-            CACHE_REGION();
-        }
-
-        UPDATE_REGION();
-        if (statics == BOARD_ALL) solved++;
-    }
-
-    // solved [rows + cols + squares]
-    return solved == 27;
-}
-
-
-
-
-
-#define PATTERN_SPIRAL_INNER    0
-#define PATTERN_SPIRAL_OUTER    1
-#define PATTERN_ROW_SNAKE       2
-#define PATTERN_COL_SNAKE       3
-
-#define N_PATTERNS              4
-
-u8 pattern_idx = 0;
-u8 patterns[N_PATTERNS][81][2];
-
-void debug_pattern(u8 pattern_id) {
-    u8 quit = 0;
-    u8 debug[81] = {};
-    for (u8 i = 0; i < 81; i++) {
-        u8 x = patterns[pattern_id][i][0];
-        u8 y = patterns[pattern_id][i][1];
-        if (x > 8 || y > 8) {
-            printf("idx:  %u    x: %u  y: %u\n", i,x,y);
-            quit = 1;
-        } else {
-            debug[(9*y) + x] = 1;
-        }
-    }
-    if (quit) return;
-    printf("\n");
-    for (u8 x = 0; x < 9; x++) {
-        for (u8 y = 0; y < 9; y++) {
-            if (debug[(9*y) + x]) printf("X ");
-            else                 printf("- ");
-        }
-        printf("\n");
-    }
-    printf("\n");
-}
-
-
-
-const u8 puzzles[16][81] = {
-    {
-        8,4,5,6,3,2,1,7,9,
-        7,3,2,9,1,8,6,5,4,
-        1,9,6,7,4,5,3,2,8,
-        6,8,3,5,7,4,9,1,2,
-        4,5,7,2,9,1,8,3,6,
-        2,1,9,8,6,3,5,4,7,
-        3,6,1,4,2,9,7,8,5,
-        5,7,4,1,8,6,2,9,3,
-        9,2,8,3,5,7,4,6,1
-    },
-    {
-        2,5,6,8,3,1,7,4,9,
-        8,3,7,6,4,9,5,1,2,
-        1,9,4,7,2,5,3,8,6,
-        6,4,1,5,8,7,9,2,3,
-        7,2,5,1,9,3,8,6,4,
-        3,8,9,4,6,2,1,7,5,
-        9,7,8,2,5,4,6,3,1,
-        5,6,2,3,1,8,4,9,7,
-        4,1,3,9,7,6,2,5,8
-    },
-    {
-        8,5,7,2,6,1,3,9,4,
-        3,1,2,4,9,5,7,8,6,
-        9,6,4,3,7,8,2,1,5,
-        1,9,5,7,3,4,6,2,8,
-        7,2,8,9,5,6,1,4,3,
-        6,4,3,1,8,2,5,7,9,
-        5,8,1,6,4,7,9,3,2,
-        4,7,9,5,2,3,8,6,1,
-        2,3,6,8,1,9,4,5,7
-    },
-    {
-        8,5,7,3,9,2,4,1,6,
-        2,1,4,8,5,6,3,7,9,
-        9,3,6,1,4,7,2,8,5,
-        5,6,8,4,2,9,1,3,7,
-        4,9,2,7,3,1,6,5,8,
-        1,7,3,6,8,5,9,4,2,
-        3,2,1,5,6,8,7,9,4,
-        6,4,5,9,7,3,8,2,1,
-        7,8,9,2,1,4,5,6,3
-    },
-    {
-        1,2,5,6,4,9,3,7,8,
-        8,3,4,7,1,5,2,9,6,
-        6,9,7,3,8,2,4,1,5,
-        7,4,6,9,5,3,1,8,2,
-        3,5,9,8,2,1,7,6,4,
-        2,8,1,4,7,6,9,5,3,
-        5,7,3,2,9,8,6,4,1,
-        4,6,8,1,3,7,5,2,9,
-        9,1,2,5,6,4,8,3,7
-    },
-    {
-        2,3,8,4,6,7,9,1,5,
-        4,1,5,2,9,3,6,7,8,
-        7,9,6,8,5,1,2,3,4,
-        9,7,3,5,4,8,1,6,2,
-        6,2,4,1,3,9,8,5,7,
-        8,5,1,7,2,6,4,9,3,
-        5,8,7,9,1,2,3,4,6,
-        1,6,2,3,7,4,5,8,9,
-        3,4,9,6,8,5,7,2,1
-    },
-    {
-        3,6,2,7,9,4,1,8,5,
-        5,1,8,6,2,3,7,9,4,
-        4,9,7,1,8,5,2,3,6,
-        8,5,9,4,6,2,3,7,1,
-        1,4,6,8,3,7,5,2,9,
-        2,7,3,5,1,9,4,6,8,
-        9,3,5,2,4,8,6,1,7,
-        7,8,1,3,5,6,9,4,2,
-        6,2,4,9,7,1,8,5,3
-    },
-    {
-        6,7,5,9,4,8,2,1,3,
-        3,2,8,1,6,5,9,7,4,
-        1,4,9,7,3,2,5,6,8,
-        2,9,1,3,5,7,4,8,6,
-        4,8,6,2,9,1,7,3,5,
-        5,3,7,6,8,4,1,2,9,
-        8,1,4,5,2,3,6,9,7,
-        9,5,2,8,7,6,3,4,1,
-        7,6,3,4,1,9,8,5,2
-    },
-    {
-        1,9,7,3,8,4,5,6,2,
-        8,5,2,6,7,1,9,3,4,
-        4,6,3,9,5,2,8,7,1,
-        5,8,9,7,1,3,2,4,6,
-        6,3,4,2,9,8,7,1,5,
-        2,7,1,4,6,5,3,9,8,
-        3,1,5,8,4,7,6,2,9,
-        7,4,6,5,2,9,1,8,3,
-        9,2,8,1,3,6,4,5,7
-    },
-    {
-        9,7,2,8,6,3,5,4,1,
-        6,1,8,7,4,5,9,2,3,
-        4,5,3,2,9,1,6,8,7,
-        5,4,9,1,2,8,7,3,6,
-        8,2,1,6,3,7,4,5,9,
-        7,3,6,4,5,9,2,1,8,
-        2,9,5,3,8,6,1,7,4,
-        1,8,4,9,7,2,3,6,5,
-        3,6,7,5,1,4,8,9,2
-    },
-    {
-        3,4,5,8,7,1,2,6,9,
-        2,7,9,6,5,3,1,8,4,
-        8,6,1,4,2,9,5,3,7,
-        1,9,7,3,4,6,8,5,2,
-        4,5,2,7,1,8,3,9,6,
-        6,8,3,5,9,2,7,4,1,
-        7,3,8,2,6,4,9,1,5,
-        5,1,6,9,3,7,4,2,8,
-        9,2,4,1,8,5,6,7,3
-    },
-    {
-        2,9,4,8,6,3,5,1,7,
-        7,1,5,4,2,9,6,3,8,
-        8,6,3,7,5,1,4,9,2,
-        1,5,2,9,4,7,8,6,3,
-        4,7,9,3,8,6,2,5,1,
-        6,3,8,5,1,2,9,7,4,
-        9,8,6,1,3,4,7,2,5,
-        5,2,1,6,7,8,3,4,9,
-        3,4,7,2,9,5,1,8,6
-    },
-    {
-        7,6,3,1,2,8,4,5,9,
-        9,2,4,5,6,7,8,3,1,
-        8,5,1,9,3,4,2,7,6,
-        4,1,8,2,9,5,3,6,7,
-        2,7,5,6,4,3,1,9,8,
-        6,3,9,7,8,1,5,4,2,
-        3,4,2,8,7,6,9,1,5,
-        1,8,6,3,5,9,7,2,4,
-        5,9,7,4,1,2,6,8,3
-    },
-    {
-        8,7,3,9,6,1,4,2,5,
-        6,2,4,7,5,3,9,1,8,
-        9,5,1,2,4,8,3,7,6,
-        5,1,8,6,9,4,2,3,7,
-        2,6,9,1,3,7,5,8,4,
-        4,3,7,5,8,2,6,9,1,
-        3,8,2,4,7,5,1,6,9,
-        7,9,5,3,1,6,8,4,2,
-        1,4,6,8,2,9,7,5,3
-    },
-    {
-        7,9,2,5,6,8,1,4,3,
-        4,5,3,2,1,9,8,6,7,
-        8,6,1,3,7,4,9,5,2,
-        6,2,5,8,9,3,7,1,4,
-        3,7,9,1,4,2,6,8,5,
-        1,4,8,7,5,6,2,3,9,
-        2,8,4,9,3,1,5,7,6,
-        9,3,7,6,8,5,4,2,1,
-        5,1,6,4,2,7,3,9,8
-    },
-    {
-        1,6,2,8,5,7,4,9,3,
-        5,3,4,1,2,9,6,7,8,
-        7,8,9,6,4,3,5,2,1,
-        4,7,5,3,1,2,9,8,6,
-        9,1,3,5,8,6,7,4,2,
-        6,2,8,7,9,4,1,3,5,
-        3,5,6,4,7,8,2,1,9,
-        2,4,1,9,3,5,8,6,7,
-        8,9,7,2,6,1,3,5,4
-    }
-};
-
-#define ACCEPTED_TRIALS     18
-#define ACCEPTED_FAILS      45
-#define OUTPUT_BOARD() {\
-    for (u32 y = 0; y < 9; y++) {\
-        for (u32 x = 0; x < 9; x++) {\
-            u16 val = board[IDX(x,y)];\
-            if (val & BOARD_FLAG_PENCIL) { printf("0 "); continue; }\
-            val &= BOARD_ALL;\
-            u8 d;\
-            for (d = 0; d < 9; d++) { if ((val>>d) & 0x1) break; }\
-            printf("%u ", (d+1)%10);\
-        }\
-        printf("\n");\
-    }\
-    printf("\n");\
-}
-
-void swap_col(u16* board, u8 a, u8 b) {
-    for (u8 i = 0; i < 9; i++) {
-        u16 tmp = board[IDX(a, i)];
-        board[IDX(a, i)] = board[IDX(b, i)];
-        board[IDX(b, i)] = tmp;
-    }
-}
-
-void swap_row(u16* board, u8 a, u8 b) {
-    for (u8 i = 0; i < 9; i++) {
-        u16 tmp = board[IDX(i, a)];
-        board[IDX(i, a)] = board[IDX(i, b)];
-        board[IDX(i, b)] = tmp;
-    }
-}
-
-u8 puzzle_idx = rand() % 16;
-void generate_puzzle(u16* board) {
-    // grab puzzle and apply mapping
-    u8 mapping[] = {1,2,3,4,5,6,7,8,9};
-    for (u8 i = 0; i < 8; i++) {
-        u8 idx       = i + rand() / (RAND_MAX / (9 - i) + 1);
-        u8 tmp       = mapping[idx];
-        mapping[idx] = mapping[i];
-        mapping[i]   = tmp;
-    }
-    
-    for (u16 j = 0; j < 9; j++) { 
-        for (u16 i = 0; i < 9; i++) { 
-            u16 x;
-            x = puzzles[puzzle_idx][(j*9)+i];
-            x = mapping[x - 1];
-            board[IDX(i,j)] = BOARD_FLAG_STATIC | (1<<(x-1));
-        }
-    }
-
-    puzzle_idx = rand() % 16; // global puzzle selector
-
-    // permute
-    for (u32 i = 0; i < 1000; i++) {
-        u32 a = rand() % 9;
-        u32 p = a % 3;
-
-        u32 b;
-        if      (p == 0) b = a + 1 + (rand() % 2);
-        else if (p == 2) b = a - 1 - (rand() % 2);
-        else if (p == 1) b = a + ((rand()%1) * 2 - 1)*(rand() % 1);
-
-        if (rand()%2 == 0) swap_row(board, a, b);
-        else               swap_col(board, a, b);
-    }
-
-#if 0
-    printf("-- Solution\n");
-    OUTPUT_BOARD();
-    printf("\n");
-#endif
-
-    u8 pattern_idx = rand() % N_PATTERNS;
-
-    // hide tiles until puzzle cannot be solved in N board iterations
-    u32  hidden[81] = {0};
-    u8   hidden_idx = 0;
-    u32  fails = 0;
-    while (1) {
-        // - hide tile
-        u16 rnd_x = rand() % 9;
-        u16 rnd_y = rand() % 9;
-        u16 idx = IDX(rnd_x, rnd_y);
-
-        // save, and skip if already hidden
-        u16 tmp = board[idx];
-        board[idx] = BOARD_EMPTY;
-        if (board[idx] == tmp) continue;
-
-        u8 solved = 0;
-        set_pencils(board, 1);
-        for (u32 n = 0; n < ACCEPTED_TRIALS; n++) {
-#if 0
-            // - solve with patterns
-            for (u8 i = 0; i < 81; i++) {
-                u8 x = patterns[pattern_idx][i][0];
-                u8 y = patterns[pattern_idx][i][1];
-                for (u32 s = 0; s < 3; s++) {
-                    u8 status = make_progress(board, x, y, s);
-                    if (status == PROGRESS_INV_CELL) break; 
-                }
-            }
-
-            // if we solved it, add the hidden tile to our collection
-            // and retry another tile
-            solved = validate_board(board);
-            if (solved) {
-                hidden[hidden_idx] = idx;
-                hidden_idx++;
-                break;
-            } 
-
-#else
-            // - solve quickly
-            solved = fast_solve(board);
-            if (solved) {
-                hidden[hidden_idx] = idx;
-                hidden_idx++;
-                break;
-            } 
-#endif
-
-        }
-
-        pattern_idx = rand() % N_PATTERNS;
-
-        // rehide tiles
-        for (u8 i = 0; i < hidden_idx; i++) {
-            board[hidden[i]] = BOARD_EMPTY;
-        }
-
-        // if we couldn't solve it, undo the tile placement and record a fail
-        if (!solved) {
-            fails++;
-            board[idx] = tmp;
-            if (fails > ACCEPTED_FAILS) break;
-        }
-
-    }
-}
-
-
 
 void main() {
     // Rasterize Font
@@ -1283,72 +384,22 @@ void main() {
     }
 
 
-    
-    // pre-compute pattern traversal arrays
-    {
-        #define BREAK  if (n > 80) break
-        #define SET(i) patterns[i][n][0] = x; patterns[i][n][1] = y; n++
-
-        // INNER SPIRAL --------
-        u8 n = 0, x = 4, y = 4;
-        SET(PATTERN_SPIRAL_INNER);
-        
-        u8 c = 1;
-        while (n < 81) {
-            /*  up  */ for (u8 i=0; i<c; i++) { y--; SET(PATTERN_SPIRAL_INNER); BREAK; } BREAK;
-            /* left */ for (u8 i=0; i<c; i++) { x--; SET(PATTERN_SPIRAL_INNER); }
-            c++;                                      
-                                                      
-            /*  down */ for (u8 i=0; i<c; i++) { y++; SET(PATTERN_SPIRAL_INNER); }
-            /* right */ for (u8 i=0; i<c; i++) { x++; SET(PATTERN_SPIRAL_INNER); }
-            c++;
-        }
-
-        // OUTER SPIRAL --------
-        n = 0, x = 9, y = 0;
-        
-        c = 9;
-        while (n < 81) {
-            /* left */ for (u8 i=0; i<c; i++) { x--; SET(PATTERN_SPIRAL_OUTER); BREAK; } BREAK;
-            c--;       
-
-            /*  down */ for (u8 i=0; i<c; i++) { y++; SET(PATTERN_SPIRAL_OUTER); }
-            /* right */ for (u8 i=0; i<c; i++) { x++; SET(PATTERN_SPIRAL_OUTER); }
-            c--;
-
-            /* up */ for (u8 i=0; i<c; i++) { y--; SET(PATTERN_SPIRAL_OUTER); }
-        }
-
-        #undef BREAK
-        #undef SET
-    }
-    {
-        // ROW SNAKE -----
-        u8 n = 0;
-        u8 dir = 0;
-        for (u8 y = 0; y < 9; y++) {
-            for (u8 x = 0; x < 9; x++) {
-                if (!dir) patterns[PATTERN_ROW_SNAKE][n][0] = x;
-                else      patterns[PATTERN_ROW_SNAKE][n][0] = 8 - x;
-                patterns[PATTERN_ROW_SNAKE][n][1] = y;
-                n++;
-            }
-            dir = (dir+1)%2;
-        }
 
-        // COL SNAKE -----
-        n = 0;
-        dir = 1;
-        for (u8 x = 0; x < 9; x++) {
-            for (u8 y = 0; y < 9; y++) {
-                patterns[PATTERN_COL_SNAKE][n][0] = x;
-                if (!dir) patterns[PATTERN_COL_SNAKE][n][1] = y;
-                else      patterns[PATTERN_COL_SNAKE][n][1] = 8 - y;
-                n++;
-            }
-            dir = (dir+1)%2;
-        }
-    }
+#ifdef TESTING_ENABLE
+    // every registered kernel has to match the reference before the game starts
+    verify_add_validate("validate_board", validate_board);
+    verify_add_validate("validate_incremental", verify_validate_incremental);
+    verify_add_solve("logic_solve_board", verify_logic_solve);
+    verify_add_fixpoint("progress worklist", verify_progress_queue);
+    if (!verify_kernels(VERIFY_SEED, VERIFY_BOARDS)) return;
+    if (!verify_grids(VERIFY_SEED, VERIFY_GRIDS)) return;
+    if (!verify_progress(VERIFY_SEED, VERIFY_FIXPOINTS)) return;
+    if (!verify_generate(VERIFY_SEED, VERIFY_PUZZLES)) return;
+    if (!verify_minimal(VERIFY_SEED, VERIFY_MINIMAL)) return;
+    if (!verify_count(VERIFY_SEED, VERIFY_COUNTS)) return;
+    if (!verify_symmetric(VERIFY_SEED, VERIFY_SYMMETRIC)) return;
+    if (!verify_canon(VERIFY_SEED, VERIFY_CANON)) return;
+#endif
 
 
     // Setup GLFW window
@@ -1463,6 +514,10 @@ void main() {
     ListItem* history_ptr = &history_root;
     u16* board_data = list_init(&history_root);
 
+    // the board texture keeps the 16x16 layout, see board_to_render
+    u16 render_data[RENDER_SIZE] = {0};
+    board_to_render(board_data, render_data);
+
     GLuint tex_board;
     glGenTextures(1, &tex_board);
     glBindTexture(GL_TEXTURE_2D, tex_board);
@@ -1474,7 +529,7 @@ void main() {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
     glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_R16UI, BOARD_DIM, BOARD_DIM, 0, GL_RED_INTEGER, GL_UNSIGNED_SHORT, board_data);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R16UI, RENDER_DIM, RENDER_DIM, 0, GL_RED_INTEGER, GL_UNSIGNED_SHORT, render_data);
 
 
 
@@ -1548,7 +603,11 @@ void main() {
     delta_us.QuadPart = 0;
 
     QueryPerformanceCounter(&start_time);
-    srand(start_time.QuadPart);
+
+    // sound picks and new puzzles, the prefetch thread takes its own stream
+    u64 seed = u64(start_time.QuadPart);
+    Rng rng;
+    rng_seed(&rng, seed, 0);
 
     i64 total_time_us = 0;
     f32 total_time    = 0.0f;
@@ -1615,12 +674,45 @@ void main() {
 
     bool waiting_for_solve = false;
 
-    u32 ai_logic_idx  = 0;
+    // placements keep the peers' pencils up to date
+    u8 auto_pencil = 0;
+
     u32 ai_cursor_idx = 0xff;
-    u8  stage         = 0;
 
-    u16 board_iterations   = 0;
-    u16 stagnation_counter = 0xFFFF; 
+    // cells worth another look by the progressive solve
+    ProgressQueue progress_queue;
+
+    // kept across solves, so re-solving a pasted puzzle is a table hit
+    TransTable solve_table;
+    tt_init(&solve_table, 16, 10);
+
+    // reused by every uniqueness check of the generator, the table across puzzles
+    TransTable generate_table;
+    tt_init(&generate_table, 16, 0);
+    SolverContext generate_context;
+    generate_context.tt = &generate_table;
+
+    // technique order adapts to the puzzles solved so far
+    LogicPipeline solve_logic;
+    logic_init(&solve_logic, 0);
+
+    // band of the puzzles ctrl+n digs out, picked with alt+1-4, and the
+    // symmetry of their givens, cycled with alt+s
+    u8 difficulty = DIFFICULTY_MEDIUM;
+    u8 symmetry   = SYMMETRY_NONE;
+
+    // puzzles are dug ahead in the background, a ctrl+n that finds its band
+    // dry is pressed again for the player as soon as the thread has one
+    Prefetcher prefetch;
+    prefetch_init(&prefetch, symmetry, seed);
+    u8 puzzle_pending = 0;
+
+    // only filled in with STATS_ENABLE
+    SolverStats solve_stats;
+    stats_reset(&solve_stats);
+
+    // edits only recheck the units they touch
+    BoardValidator board_validator;
 
 
     while (!glfwWindowShouldClose(window))
@@ -1629,6 +721,14 @@ void main() {
         QueryPerformanceCounter(&start_time);
         glfwPollEvents();
 
+        if (puzzle_pending && prefetch_ready(&prefetch, difficulty) && input_index < INPUT_QUEUE_LEN) {
+            input_queue[input_index].type   = INPUT_TYPE_KEY_PRESS;
+            input_queue[input_index].action = GLFW_PRESS;
+            input_queue[input_index].mod    = GLFW_MOD_CONTROL;
+            input_queue[input_index].key    = GLFW_KEY_N;
+            input_index++;
+        }
+
 
         // window - resizing
         i32 _width = 0, _height = 0;
@@ -1675,6 +775,11 @@ void main() {
 
             u8 set_digit = 0;
 
+            // the one cell most inputs change, bulk changes refill every candidate
+            u8  edit_idx    = cursor_idx;
+            u16 edit_before = board_data[cursor_idx];
+            u8  board_bulk  = 0;
+
 
             // mouse coords [0,dim] -> [0,1]
             f32 screen_x = event.mouse_position[0] / window_width;
@@ -1727,7 +832,7 @@ void main() {
                     e.volume   = 0.03f;
 
                     // sample from click velocity
-                    if (dt > 0.25)  e.sound_id = (rand() % 2) ? SOUND_IMPACT_2 : SOUND_IMPACT_3;
+                    if (dt > 0.25)  e.sound_id = rng_below(&rng, 2) ? SOUND_IMPACT_2 : SOUND_IMPACT_3;
                     else            e.sound_id = SOUND_IMPACT_1;
 
                     // angle from mouse position
@@ -1778,9 +883,9 @@ void main() {
                         e.volume   = 0.011f;
 
                         {
-                            u8 rng       = rand()%4;
+                            u8 pick      = u8(rng_below(&rng, 4));
                             u8 sounds[4] = {SOUND_CLEAR_1, SOUND_CLEAR_2, SOUND_CLEAR_3, SOUND_CLEAR_4};
-                            e.sound_id   = sounds[rng];
+                            e.sound_id   = sounds[pick];
                         }
 
                         // angle from board position
@@ -1809,22 +914,31 @@ void main() {
                                 if (event.mod & GLFW_MOD_CONTROL) {
                                     // instant solve
                                     set_pencils(board_data, !(event.mod & GLFW_MOD_SHIFT));
-                                    for (u32 n = 0; n < ACCEPTED_TRIALS; n++) {
-                                        u8 solved = fast_solve(board_data);
-                                        if (solved) break;
+                                    stats_reset(&solve_stats);
+                                    u8 solved = logic_solve_board(board_data, &solve_logic, &solve_stats);
+
+                                    // logic wasn't enough, fall back to search
+                                    if (!solved) {
+                                        search_solve(board_data, &solve_table, &solve_stats);
+#ifdef STATS_ENABLE
+                                        printf("[Search] tt hit rate %.3f  (%llu probes)\n", 
+                                               tt_hit_rate(&solve_table), solve_table.probes);
+#endif
                                     }
+#ifdef STATS_ENABLE
+                                    stats_print(&solve_stats);
+#endif
                                     waiting_for_solve = false;
                                     board_input       = 1;
                                 } else {
                                     // progressive solve
                                     solve_wait_us = solve_true_us;
 
-                                    ai_logic_idx     = 0;
                                     ai_cursor_idx    = 0xff;
-                                    board_iterations = 0;
                                     board_input      = 1;
 
                                     waiting_for_solve = set_pencils(board_data, !(event.mod & GLFW_MOD_SHIFT));
+                                    queue_init(&progress_queue, board_data);
                                 }
                                 break;
                             }
@@ -1858,7 +972,7 @@ void main() {
                 // square check
                 if (!handled && (event.mod & GLFW_MOD_CONTROL) && KEY_UP(GLFW_KEY_2)) {
                     u16 base_idx = IDX(cursor_x, cursor_y);
-                    _solve_square(board_data, base_idx, cursor_x, cursor_y, 1);
+                    _solve_square(board_data, base_idx, cursor_x, cursor_y, 1, NULL);
                     board_input = 1;
                     handled = 1;
                 }
@@ -1866,7 +980,7 @@ void main() {
                 // row check
                 if (!handled && (event.mod & GLFW_MOD_CONTROL) && KEY_UP(GLFW_KEY_3)) {
                     u16 base_idx = IDX(cursor_x, cursor_y);
-                    _solve_row(board_data, base_idx, cursor_y);
+                    _solve_row(board_data, base_idx, cursor_y, NULL);
                     board_input = 1;
                     handled = 1;
                 }
@@ -1874,7 +988,7 @@ void main() {
                 // col check
                 if (!handled && (event.mod & GLFW_MOD_CONTROL) && KEY_UP(GLFW_KEY_4)) {
                     u16 base_idx = IDX(cursor_x, cursor_y);
-                    _solve_col(board_data, base_idx, cursor_x);
+                    _solve_col(board_data, base_idx, cursor_x, NULL);
                     board_input = 1;
                     handled = 1;
                 }
@@ -1886,6 +1000,7 @@ void main() {
                         if (board_data[i] & BOARD_ALL) board_data[i] ^= BOARD_FLAG_STATIC;
                     }
                     board_input = 1;
+                    board_bulk  = 1;
                     handled = 1;
                 }
 
@@ -1896,16 +1011,54 @@ void main() {
                     }
                     board_data[cursor_idx] |= BOARD_FLAG_CURSOR;
                     board_input = 1;
+                    board_bulk  = 1;
+                    handled = 1;
+                }
+
+
+                // auto candidates
+                if (!handled && (event.mod & GLFW_MOD_CONTROL) && KEY_DOWN(GLFW_KEY_P)) {
+                    auto_pencil ^= 1;
+                    board_input  = 1;
+                    board_bulk   = 1;
+                    handled      = 1;
+                }
+
+
+                // difficulty of the next puzzle
+                if (!handled && (event.mod & GLFW_MOD_ALT) && IS_KEY_DOWN && event.key >= GLFW_KEY_1 && event.key < GLFW_KEY_1 + N_DIFFICULTIES) {
+                    difficulty = u8(event.key - GLFW_KEY_1);
+                    printf("[Generate] %s\n", difficulty_names[difficulty]);
                     handled = 1;
                 }
 
+                if (!handled && (event.mod & GLFW_MOD_ALT) && KEY_DOWN(GLFW_KEY_S)) {
+                    symmetry = (symmetry + 1) % N_SYMMETRIES;
+                    printf("[Generate] symmetry %s\n", symmetry_names[symmetry]);
+                    prefetch_symmetry(&prefetch, symmetry);
+                    handled = 1;
+                }
 
-                // new puzzle
+                // new puzzle, with shift any unique one rather than one in the difficulty's band
                 if (!handled && (event.mod & GLFW_MOD_CONTROL) && KEY_DOWN(GLFW_KEY_N)) {
-                    generate_puzzle(board_data);
-                    board_data[cursor_idx] |= BOARD_FLAG_CURSOR;
-                    handled     = 1;
-                    board_input = 1;
+                    u8 fresh = 1;
+                    if (event.mod & GLFW_MOD_SHIFT) generate_unique(board_data, &generate_context, &rng);
+                    else fresh = prefetch_pop(&prefetch, difficulty, board_data, PREFETCH_WAIT_MS);
+
+                    // never dig on the frame, the board stays until the thread has one
+                    if (!fresh && !puzzle_pending) printf("[Generate] %s puzzle still being made\n", difficulty_names[difficulty]);
+                    puzzle_pending = !fresh;
+#ifdef STATS_ENABLE
+                    prefetch_print(&prefetch);
+                    printf("[Generate] unique tt hit rate %.3f  (%llu probes)\n",
+                           tt_hit_rate(&generate_table), generate_table.probes);
+#endif
+                    handled = 1;
+                    if (fresh) {
+                        board_data[cursor_idx] |= BOARD_FLAG_CURSOR;
+                        board_input = 1;
+                        board_bulk  = 1;
+                    }
                 }
 
 
@@ -1913,6 +1066,7 @@ void main() {
                 if (!handled && (event.mod & GLFW_MOD_CONTROL) && KEY_DOWN(GLFW_KEY_R)) {
                     handled     = 1;
                     board_input = 1;
+                    board_bulk  = 1;
                     for (u32 j = 0; j < 9; j++){
                         for (u32 i = 0; i < 9; i++){
                             if (!(board_data[IDX(i,j)] & BOARD_FLAG_STATIC)) {
@@ -1977,12 +1131,12 @@ void main() {
 
                             // sample from key velocity
                             if (board_data[idx] & BOARD_FLAG_PENCIL) {
-                                if (dt > 0.25)  e.sound_id = (rand() % 2) ? SOUND_PENCIL_3 : SOUND_PENCIL_4;
-                                else            e.sound_id = (rand() % 2) ? SOUND_PENCIL_1 : SOUND_PENCIL_2;
+                                if (dt > 0.25)  e.sound_id = rng_below(&rng, 2) ? SOUND_PENCIL_3 : SOUND_PENCIL_4;
+                                else            e.sound_id = rng_below(&rng, 2) ? SOUND_PENCIL_1 : SOUND_PENCIL_2;
                             } else {
                                 set_digit = 1;
-                                if (dt > 0.25)  e.sound_id = (rand() % 2) ? SOUND_PEN_3 : SOUND_PEN_4;
-                                else            e.sound_id = (rand() % 2) ? SOUND_PEN_1 : SOUND_PEN_2;
+                                if (dt > 0.25)  e.sound_id = rng_below(&rng, 2) ? SOUND_PEN_3 : SOUND_PEN_4;
+                                else            e.sound_id = rng_below(&rng, 2) ? SOUND_PEN_1 : SOUND_PEN_2;
                             }
 
                             // angle from board position
@@ -2102,6 +1256,7 @@ void main() {
 
                     if (by > 7) {
                         board_input = 1;
+                        board_bulk  = 1;
                         board_data[cursor_idx] |= BOARD_FLAG_CURSOR;
                     } else {
                         printf("[Error] Not enough board data.");
@@ -2152,7 +1307,13 @@ void main() {
                 history_ptr->type     = board_input_type;
                 history_ptr->cursor_x = cursor_x;
                 history_ptr->cursor_y = cursor_y;
-                u8 won = validate_board(board_data);
+
+                if (auto_pencil) {
+                    if (board_bulk) fill_candidates(board_data);
+                    else            update_candidates(board_data, edit_idx, edit_before);
+                }
+
+                u8 won = validate_incremental(&board_validator, board_data);
                 if (won && set_digit) {
                     Event e;
                     e.mode     = EventMode::start;
@@ -2179,134 +1340,99 @@ void main() {
                 stepper = 0;
                 using_stepper = 0;
 
-                u8 status = PROGRESS_INV_CELL; 
-                while(status == PROGRESS_INV_CELL) {
-                    u8  base_x    = patterns[pattern_idx][ai_logic_idx][0];
-                    u8  base_y    = patterns[pattern_idx][ai_logic_idx][1];
-                    ai_cursor_idx = IDX(base_x, base_y);
-                    status = make_progress(board_data, base_x, base_y, stage, board_iterations > 3);
-
-                    // debug
-                    if (status == PROGRESS_DEBUG) {
-                        status = PROGRESS_SET_CELL;
-                        using_stepper = using_stepper_running;
-                    }
-
-                    // keep track of stagnation
-                    if (stagnation_counter == 0xFFFF && status == PROGRESS_DEFAULT) {
-                        stagnation_counter = board_iterations;
-                    }
-
-                    // set AI cursor
-                    if (status == PROGRESS_STATE_CHANGE || status == PROGRESS_SET_CELL) {
-                        stagnation_counter = 0xFFFF;
-                    } 
-
-                    // p1: no state change => time to give up
-                    // p3: board solved => time to stop
-                    bool p1 = (stagnation_counter != 0xFFFF && board_iterations - stagnation_counter > 2*N_PATTERNS);
-                    bool p2 = (status == PROGRESS_STATE_CHANGE || status == PROGRESS_SET_CELL);
-
-                    if (p2) {
-                        i64 dt_us = total_time_us - total_time_at_prog_us;
+                u8 status     = queue_step(&progress_queue, board_data, &solve_stats);
+                ai_cursor_idx = progress_queue.cell;
 
-                        Event e;
-                        e.mode   = EventMode::start;
-                        e.layer  = 0;
+                // debug
+                if (status == PROGRESS_DEBUG) {
+                    status = PROGRESS_SET_CELL;
+                    using_stepper = using_stepper_running;
+                }
 
-                        // sample from solve velocity
-                        if (board_data[ai_cursor_idx] & BOARD_FLAG_PENCIL) {
-                            u8 rng = rand() % 3;
-                            u8 sounds[3] = {SOUND_PENCIL_1,SOUND_PENCIL_2,SOUND_PENCIL_3};
-                            e.sound_id = sounds[rng];
+                // p1: nothing left queued => time to give up
+                // p3: board solved => time to stop
+                bool p1 = (status == PROGRESS_FIXPOINT);
+                bool p2 = (status == PROGRESS_STATE_CHANGE || status == PROGRESS_SET_CELL);
 
-                            // note: ideally you'd just have more samples but im too lazy to record
-                            if      (dt_us > 500000) e.volume = 0.0080f;
-                            else if (dt_us > 350000) e.volume = 0.0070f;
-                            else if (dt_us > 200000) e.volume = 0.0050f;
-                            else                     e.volume = 0.0037f;
+                if (p2) {
+                    i64 dt_us = total_time_us - total_time_at_prog_us;
 
-                        } else {
-                            u8 rng = rand() % 3;
-                            u8 sounds[3] = {SOUND_PEN_1,SOUND_PEN_2,SOUND_PEN_3};
-                            e.sound_id = sounds[rng];
-
-                            // note: ideally you'd just have more samples but im too lazy to record
-                            if      (dt_us > 500000) e.volume = 0.0070f;
-                            else if (dt_us > 350000) e.volume = 0.0055f;
-                            else if (dt_us > 200000) e.volume = 0.0033f;
-                            else                     e.volume = 0.0013f;
-                        }
+                    Event e;
+                    e.mode   = EventMode::start;
+                    e.layer  = 0;
 
-                        // angle from board position
-                        {
-                            f32 range = 0.12f;
-                            e.angle = (1.0f - (f32(base_x)/8.0f)) * (1.0f - (2.0f*range)) + range;
-                        }
+                    // sample from solve velocity
+                    if (board_data[ai_cursor_idx] & BOARD_FLAG_PENCIL) {
+                        u8 pick = u8(rng_below(&rng, 3));
+                        u8 sounds[3] = {SOUND_PENCIL_1,SOUND_PENCIL_2,SOUND_PENCIL_3};
+                        e.sound_id = sounds[pick];
 
-                        ring_push(local_events, e);
-                        audio_updated = 1;
+                        // note: ideally you'd just have more samples but im too lazy to record
+                        if      (dt_us > 500000) e.volume = 0.0080f;
+                        else if (dt_us > 350000) e.volume = 0.0070f;
+                        else if (dt_us > 200000) e.volume = 0.0050f;
+                        else                     e.volume = 0.0037f;
 
-                        total_time_at_prog_us = total_time_us;
+                    } else {
+                        u8 pick = u8(rng_below(&rng, 3));
+                        u8 sounds[3] = {SOUND_PEN_1,SOUND_PEN_2,SOUND_PEN_3};
+                        e.sound_id = sounds[pick];
+
+                        // note: ideally you'd just have more samples but im too lazy to record
+                        if      (dt_us > 500000) e.volume = 0.0070f;
+                        else if (dt_us > 350000) e.volume = 0.0055f;
+                        else if (dt_us > 200000) e.volume = 0.0033f;
+                        else                     e.volume = 0.0013f;
                     }
 
-                    // if not time to give up and we actually did something, check for win
-                    u8 p3 = 0;
-                    if (!p1 && p2) p3 = validate_board(board_data);
-                    if (p3) {
-                        Event e;
-                        e.mode     = EventMode::start;
-                        e.layer    = 0;
-                        e.sound_id = SOUND_AI_WIN;
-                        e.angle    = 0.5f;
-                        e.volume   = 0.200f;
-
-                        ring_push(local_events, e);
-                        audio_updated = 1;
+                    // angle from board position
+                    {
+                        f32 range = 0.12f;
+                        u8  base_x = board_tables.col[ai_cursor_idx];
+                        e.angle = (1.0f - (f32(base_x)/8.0f)) * (1.0f - (2.0f*range)) + range;
                     }
 
-                    // so if stagnated, or we won, finish
-                    if (p1 || p3) {
-                        solve_wait_us     = solve_true_us;
-                        waiting_for_solve = false;
-                        board_iterations  = 0xFFFF;
+                    ring_push(local_events, e);
+                    audio_updated = 1;
 
-                        pattern_idx   = 0;
-                        ai_logic_idx  = 0;
-                        ai_cursor_idx = 0xff;
+                    total_time_at_prog_us = total_time_us;
+                }
 
-                        break;
-                    }
+                // if not time to give up and we actually did something, check for win
+                u8 p3 = 0;
+                if (!p1 && p2) p3 = validate_incremental(&board_validator, board_data);
+                if (p3) {
+                    Event e;
+                    e.mode     = EventMode::start;
+                    e.layer    = 0;
+                    e.sound_id = SOUND_AI_WIN;
+                    e.angle    = 0.5f;
+                    e.volume   = 0.200f;
 
-                    // speed up over time
-                    if (status == PROGRESS_SET_CELL) {
-                        if (solve_wait_us < solve_min_us) {
-                            solve_wait_us = solve_min_us;
-                        } else {
-                            solve_wait_us *= 0.94f;
-                        }
-                    }
+                    ring_push(local_events, e);
+                    audio_updated = 1;
+                }
 
-                    // nothing set, retry again next iteration
-                    if (status == PROGRESS_DEFAULT) {
-                        solve_timer_us = solve_wait_us;
-                        stepper = 1;
+                // speed up over time
+                if (status == PROGRESS_SET_CELL) {
+                    if (solve_wait_us < solve_min_us) {
+                        solve_wait_us = solve_min_us;
+                    } else {
+                        solve_wait_us *= 0.94f;
                     }
+                }
 
-                    if (status == PROGRESS_INV_CELL) { stage = 0; ai_logic_idx++; }
-                    else {
-                        stage++;
-                        if (status == PROGRESS_SET_CELL) stage = 3; // force increment
-                        if (stage  > 2) { stage  = 0; ai_logic_idx++; }
-                    }
-                    if (ai_logic_idx > 81) { 
-                        u8 tmp = pattern_idx;
-                        pattern_idx = rand() % N_PATTERNS; 
-                        if (pattern_idx == tmp) pattern_idx = (pattern_idx+1) % N_PATTERNS;
+                // nothing set, retry again next iteration
+                if (status == PROGRESS_DEFAULT) {
+                    solve_timer_us = solve_wait_us;
+                    stepper = 1;
+                }
 
-                        ai_logic_idx = 0; 
-                        board_iterations++; 
-                    }
+                // so if stagnated, or we won, finish
+                if (p1 || p3) {
+                    solve_wait_us     = solve_true_us;
+                    waiting_for_solve = false;
+                    ai_cursor_idx     = 0xff;
                 }
             }
         }
@@ -2362,7 +1488,8 @@ void main() {
 
             glActiveTexture(GL_TEXTURE0 + 1);
             glBindTexture(GL_TEXTURE_2D, tex_board);
-            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, BOARD_DIM, BOARD_DIM, GL_RED_INTEGER, GL_UNSIGNED_SHORT, board_data);
+            board_to_render(board_data, render_data);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, RENDER_DIM, RENDER_DIM, GL_RED_INTEGER, GL_UNSIGNED_SHORT, render_data);
 
             glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
 
@@ -2407,6 +1534,8 @@ void main() {
         total_time = f64(total_time_us) / pow_10[6];
     }
 
+    prefetch_free(&prefetch);
+
     glfwDestroyWindow(window);
     glfwTerminate();
 }
@@ -0,0 +1,93 @@
+#include "proj_pool.h"
+
+
+// -- Workers
+void _pool_drain(ThreadPool* pool, u32 worker) {
+    while (!pool->cancel) {
+        u32 index = u32(InterlockedIncrement(&pool->next) - 1);
+        if (index >= pool->count) break;
+        pool->task(pool->args, index, worker);
+    }
+}
+
+struct _PoolWorker {
+    ThreadPool* pool;
+    u32         worker;
+};
+
+DWORD _pool_loop(_PoolWorker* self) {
+    ThreadPool* pool = self->pool;
+    u32 worker       = self->worker;
+    free(self);
+
+    while (1) {
+        WaitForSingleObject(pool->start, INFINITE);
+        if (pool->quit) break;
+
+        _pool_drain(pool, worker);
+        if (!InterlockedDecrement(&pool->active)) SetEvent(pool->done);
+    }
+    return 0;
+}
+
+
+
+// -- Pool
+void pool_init(ThreadPool* pool, u32 n_threads) {
+    if (!n_threads) {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        n_threads = info.dwNumberOfProcessors;
+    }
+    if (!n_threads) n_threads = 1;
+
+    pool->n_threads = n_threads;
+    pool->start     = CreateSemaphore(NULL, 0, n_threads, NULL);
+    pool->done      = CreateEvent(NULL, FALSE, FALSE, NULL);
+    pool->quit      = 0;
+
+    // the caller works too, so one thread less
+    pool->threads = (HANDLE*) malloc(sizeof(HANDLE) * n_threads);
+    for (u32 i = 1; i < n_threads; i++) {
+        _PoolWorker* worker = (_PoolWorker*) malloc(sizeof(_PoolWorker));
+        worker->pool   = pool;
+        worker->worker = i;
+        pool->threads[i] = CreateThread(NULL, 0, (LPTHREAD_START_ROUTINE) _pool_loop, worker, 0, NULL);
+    }
+}
+
+void pool_free(ThreadPool* pool) {
+    pool->quit = 1;
+    if (pool->n_threads > 1) {
+        ReleaseSemaphore(pool->start, pool->n_threads - 1, NULL);
+        WaitForMultipleObjects(pool->n_threads - 1, &pool->threads[1], TRUE, INFINITE);
+    }
+    for (u32 i = 1; i < pool->n_threads; i++) CloseHandle(pool->threads[i]);
+
+    CloseHandle(pool->start);
+    CloseHandle(pool->done);
+    free(pool->threads);
+    pool->threads   = NULL;
+    pool->n_threads = 0;
+}
+
+void pool_run(ThreadPool* pool, PoolTask task, void* args, u32 count) {
+    pool->task   = task;
+    pool->args   = args;
+    pool->count  = count;
+    pool->next   = 0;
+    pool->cancel = 0;
+
+    // no point waking more workers than there are indices
+    u32 n_workers = pool->n_threads - 1;
+    if (n_workers > count) n_workers = count;
+    pool->active = n_workers;
+
+    if (n_workers) ReleaseSemaphore(pool->start, n_workers, NULL);
+    _pool_drain(pool, 0);
+    if (n_workers) WaitForSingleObject(pool->done, INFINITE);
+}
+
+void pool_cancel(ThreadPool* pool) {
+    InterlockedExchange(&pool->cancel, 1);
+}
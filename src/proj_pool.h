@@ -0,0 +1,49 @@
+#ifndef PROJ_POOL_H
+#define PROJ_POOL_H
+
+// local
+#include "proj_types.h"
+
+// third party
+#include "windows.h"
+
+// system
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+
+
+/*
+    worker pool for independent solver jobs
+
+    pool_run hands out the indices [0, count) to the workers and the
+    calling thread, and returns once every index is done. a task may call
+    pool_cancel to skip whatever indices haven't been handed out yet.
+*/
+typedef void (*PoolTask)(void* args, u32 index, u32 worker);
+
+struct ThreadPool {
+    u32     n_threads     = 0;      // workers + the caller
+    HANDLE* threads       = NULL;
+    HANDLE  start         = NULL;   // semaphore, one count per worker per run
+    HANDLE  done          = NULL;   // set by the last worker out
+
+    PoolTask task         = NULL;
+    void*    args         = NULL;
+    u32      count        = 0;
+
+    volatile long next     = 0;
+    volatile long active   = 0;
+    volatile long cancel   = 0;
+    volatile long quit     = 0;
+};
+
+// n_threads 0 uses one thread per processor
+void pool_init(ThreadPool* pool, u32 n_threads);
+void pool_free(ThreadPool* pool);
+
+void pool_run(ThreadPool* pool, PoolTask task, void* args, u32 count);
+void pool_cancel(ThreadPool* pool);
+
+#endif
@@ -0,0 +1,186 @@
+#include "proj_prefetch.h"
+
+
+// -- Rings
+// the refilling ring with the fewest puzzles, N_DIFFICULTIES if all are topped up
+u8 _prefetch_next(Prefetcher* p) {
+    u8  best  = N_DIFFICULTIES;
+    u32 least = PREFETCH_DEPTH;
+
+    for (u8 d = 0; d < N_DIFFICULTIES; d++) {
+        PrefetchRing* ring = &p->rings[d];
+        u32 count = u32(ring->count);
+
+        if (count < PREFETCH_LOW_WATER) ring->refilling = 1;
+        if (count >= PREFETCH_DEPTH)    ring->refilling = 0;
+
+        if (ring->refilling && count < least) {
+            best  = d;
+            least = count;
+        }
+    }
+    return best;
+}
+
+void _prefetch_push(PrefetchRing* ring, const u16* board, u8 symmetry) {
+    u32 slot = ring->tail % PREFETCH_DEPTH;
+    memcpy(ring->puzzles[slot], board, BOARD_SIZE * sizeof(u16));
+    ring->symmetry[slot] = symmetry;
+    ring->tail++;
+
+    // the interlocked add is the barrier, the reader sees the slot whole
+    InterlockedIncrement(&ring->count);
+}
+
+// moves the puzzle at the head aside, reader only
+void _prefetch_stash(PrefetchRing* ring) {
+    u32 slot = ring->head % PREFETCH_DEPTH;
+    memcpy(ring->stale[ring->stale_top % PREFETCH_DEPTH], ring->puzzles[slot], BOARD_SIZE * sizeof(u16));
+    ring->stale_top++;
+    if (ring->n_stale < PREFETCH_DEPTH) ring->n_stale++;
+
+    ring->head++;
+    InterlockedDecrement(&ring->count);
+}
+
+// the first puzzle dug with the current symmetry, else the newest old one
+u8 _prefetch_take(Prefetcher* p, PrefetchRing* ring, u16* board) {
+    while (ring->count > 0) {
+        u32 slot = ring->head % PREFETCH_DEPTH;
+        if (ring->symmetry[slot] != u8(p->symmetry)) {
+            _prefetch_stash(ring);
+            continue;
+        }
+        memcpy(board, ring->puzzles[slot], BOARD_SIZE * sizeof(u16));
+        ring->head++;
+        InterlockedDecrement(&ring->count);
+        return 1;
+    }
+
+    if (!ring->n_stale) return 0;
+    ring->stale_top--;
+    ring->n_stale--;
+    memcpy(board, ring->stale[ring->stale_top % PREFETCH_DEPTH], BOARD_SIZE * sizeof(u16));
+    p->stale++;
+    return 1;
+}
+
+
+
+// -- Thread
+DWORD _prefetch_thread(Prefetcher* p) {
+    while (!p->quit) {
+        u8 d = _prefetch_next(p);
+        if (d == N_DIFFICULTIES) {
+            WaitForSingleObject(p->wake, INFINITE);
+            continue;
+        }
+
+        u8  symmetry = u8(p->symmetry);
+        u16 board[BOARD_SIZE];
+
+        u64 start = stats_ticks();
+        generate_puzzle(board, difficulty_ranges[d], GENERATE_BUDGET_US, symmetry, &p->rng, NULL);
+        p->generate_ns += stats_ticks_to_ns(stats_ticks() - start);
+        p->generated++;
+
+        // symmetry changed while digging, nobody wants this one
+        if (symmetry != u8(p->symmetry)) continue;
+        _prefetch_push(&p->rings[d], board, symmetry);
+        SetEvent(p->pushed);
+    }
+    return 0;
+}
+
+
+
+// -- Prefetcher
+void prefetch_init(Prefetcher* p, u8 symmetry, u64 seed) {
+    for (u8 d = 0; d < N_DIFFICULTIES; d++) {
+        p->rings[d].head      = 0;
+        p->rings[d].tail      = 0;
+        p->rings[d].count     = 0;
+        p->rings[d].refilling = 1;
+        p->rings[d].stale_top = 0;
+        p->rings[d].n_stale   = 0;
+    }
+    p->symmetry    = symmetry;
+    p->quit        = 0;
+    p->generated   = 0;
+    p->generate_ns = 0;
+    p->popped      = 0;
+    p->missed      = 0;
+    p->stale       = 0;
+    rng_seed(&p->rng, seed, PREFETCH_STREAM);
+
+    p->wake   = CreateEvent(NULL, FALSE, FALSE, NULL);
+    p->pushed = CreateEvent(NULL, FALSE, FALSE, NULL);
+    p->thread = CreateThread(NULL, 0, (LPTHREAD_START_ROUTINE) _prefetch_thread, p, 0, NULL);
+
+    // digging competes with the frame, not the other way round
+    SetThreadPriority(p->thread, THREAD_PRIORITY_BELOW_NORMAL);
+}
+
+void prefetch_free(Prefetcher* p) {
+    if (!p->thread) return;
+
+    // waits out the puzzle being dug, at most one budget
+    InterlockedExchange(&p->quit, 1);
+    SetEvent(p->wake);
+    WaitForSingleObject(p->thread, INFINITE);
+
+    CloseHandle(p->thread);
+    CloseHandle(p->wake);
+    CloseHandle(p->pushed);
+    p->thread = NULL;
+    p->wake   = NULL;
+    p->pushed = NULL;
+}
+
+u8 prefetch_pop(Prefetcher* p, u8 difficulty, u16* board, u32 wait_ms) {
+    PrefetchRing* ring = &p->rings[difficulty];
+
+    u64 start = stats_ticks();
+    u8  found = _prefetch_take(p, ring, board);
+    while (!found) {
+        u64 waited_ms = stats_ticks_to_ns(stats_ticks() - start) / 1000000;
+        if (waited_ms >= wait_ms) break;
+
+        // a push to any ring wakes this, only the right one ends the wait
+        WaitForSingleObject(p->pushed, DWORD(wait_ms - waited_ms));
+        found = _prefetch_take(p, ring, board);
+    }
+
+    if (found) p->popped++;
+    else       p->missed++;
+
+    SetEvent(p->wake);
+    return found;
+}
+
+u8 prefetch_ready(Prefetcher* p, u8 difficulty) {
+    return p->rings[difficulty].count > 0 || p->rings[difficulty].n_stale > 0;
+}
+
+void prefetch_symmetry(Prefetcher* p, u8 symmetry) {
+    InterlockedExchange(&p->symmetry, symmetry);
+
+    // set what was dug with the old one aside, the emptied rings get dug again.
+    // anything pushed after is set aside by the pop
+    for (u8 d = 0; d < N_DIFFICULTIES; d++) {
+        PrefetchRing* ring = &p->rings[d];
+        while (ring->count > 0 && ring->symmetry[ring->head % PREFETCH_DEPTH] != symmetry) _prefetch_stash(ring);
+    }
+    SetEvent(p->wake);
+}
+
+void prefetch_print(Prefetcher* p) {
+    printf("[Prefetch] depth");
+    for (u8 d = 0; d < N_DIFFICULTIES; d++) printf(" %s %ld", difficulty_names[d], p->rings[d].count);
+    printf(" :: %llu popped, %llu missed, %llu of an earlier symmetry\n", p->popped, p->missed, p->stale);
+
+    if (p->generated) {
+        f64 ms = f64(p->generate_ns) / f64(p->generated) / 1e6;
+        printf("[Prefetch] %llu dug, %.2fms each :: %.1f puzzles/s refill\n", p->generated, ms, 1000.0 / ms);
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef PROJ_PREFETCH_H
+#define PROJ_PREFETCH_H
+
+// local
+#include "proj_types.h"
+#include "proj_board.h"
+#include "proj_stats.h"
+#include "proj_rand.h"
+
+// third party
+#include "windows.h"
+
+// system
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+
+
+/*
+    puzzle prefetch
+
+    a background thread keeps up to PREFETCH_DEPTH ready puzzles for every
+    difficulty, so a new puzzle is a pop instead of a dig. a ring that
+    drops under PREFETCH_LOW_WATER is filled back up to the top, the
+    emptiest first, and with nothing to fill the thread sleeps until a pop
+    wakes it.
+
+    each ring has one writer (the thread) and one reader (the game), so
+    head and tail are private to their side and only count is shared.
+    a puzzle is tagged with the symmetry it was dug with. a change of
+    symmetry moves the rings' puzzles aside, from the reader's side, so
+    the thread digs new ones while a pop still has the old ones to fall
+    back on until the new ones are in.
+
+    a pop that finds nothing waits on the thread's pushes for at most
+    the time it's given, it never digs itself.
+
+    the thread digs from its own stream of the seed it's started with.
+*/
+#define PREFETCH_DEPTH          8
+#define PREFETCH_LOW_WATER      4
+#define PREFETCH_STREAM         1           // the game's own draws take stream 0
+#define PREFETCH_WAIT_MS        30          // how long ctrl+n waits on an empty ring, about two frames
+
+struct PrefetchRing {
+    u16           puzzles[PREFETCH_DEPTH][BOARD_SIZE];
+    u8            symmetry[PREFETCH_DEPTH];
+    u32           head      = 0;            // reader only
+    u32           tail      = 0;            // writer only
+    volatile long count     = 0;
+    u8            refilling = 1;            // writer only, under the low water mark until full
+
+    // reader only, dug with an earlier symmetry, newest on top
+    u16           stale[PREFETCH_DEPTH][BOARD_SIZE];
+    u32           stale_top = 0;
+    u32           n_stale   = 0;
+};
+
+struct Prefetcher {
+    PrefetchRing  rings[N_DIFFICULTIES];
+    volatile long symmetry  = SYMMETRY_NONE;
+    volatile long quit      = 0;
+    HANDLE        thread    = NULL;
+    HANDLE        wake      = NULL;         // auto reset event, set by pops
+    HANDLE        pushed    = NULL;         // auto reset event, set by the thread after every push
+    Rng           rng;                      // thread only
+
+    // stats, written by their own side only
+    u64           generated   = 0;
+    u64           generate_ns = 0;
+    u64           popped      = 0;
+    u64           missed      = 0;          // pops that found nothing, even after waiting
+    u64           stale       = 0;          // pops that fell back on an earlier symmetry
+};
+
+void prefetch_init(Prefetcher* p, u8 symmetry, u64 seed);
+void prefetch_free(Prefetcher* p);
+
+// waits up to wait_ms for the thread to push one when none is ready.
+// 0 if there still isn't one, board is left alone then
+u8   prefetch_pop(Prefetcher* p, u8 difficulty, u16* board, u32 wait_ms);
+u8   prefetch_ready(Prefetcher* p, u8 difficulty);
+void prefetch_symmetry(Prefetcher* p, u8 symmetry);
+
+// ring depths and how fast the thread refills them
+void prefetch_print(Prefetcher* p);
+
+#endif
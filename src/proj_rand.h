@@ -0,0 +1,65 @@
+#ifndef PROJ_RAND_H
+#define PROJ_RAND_H
+
+// local
+#include "proj_types.h"
+
+
+
+/*
+    random numbers
+
+    xoshiro256** with its state in an Rng the caller owns, so every thread
+    has its own and nothing is shared behind the scenes. the same seed and
+    stream give the same numbers on every machine, which is all it takes
+    to make a puzzle again from its seed.
+
+    the four state words come from splitmix64, started from seed with the
+    stream mixed in. streams of one seed are unrelated, a thread or a
+    puzzle index makes a good one.
+*/
+struct Rng {
+    u64 s[4];
+};
+
+// constexpr, the zobrist keys are drawn from it at compile time
+constexpr u64 _rng_splitmix(u64* x) {
+    u64 z = (*x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+inline void rng_seed(Rng* rng, u64 seed, u64 stream) {
+    u64 s = stream;
+    u64 x = seed ^ _rng_splitmix(&s);
+    for (u8 i = 0; i < 4; i++) rng->s[i] = _rng_splitmix(&x);
+}
+
+inline u64 rng_next(Rng* rng) {
+    u64* s = rng->s;
+    u64  r = s[1] * 5;
+    r = ((r << 7) | (r >> 57)) * 9;
+
+    u64 t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3]  = (s[3] << 45) | (s[3] >> 19);
+    return r;
+}
+
+// uniform in [0, n), n > 0. the high bits times n, redrawn on the few
+// values that would lean low (no division unless it comes to that)
+inline u32 rng_below(Rng* rng, u32 n) {
+    u64 m = (rng_next(rng) >> 32) * n;
+    if (u32(m) < n) {
+        u32 limit = (0u - n) % n;
+        while (u32(m) < limit) m = (rng_next(rng) >> 32) * n;
+    }
+    return u32(m >> 32);
+}
+
+#endif
@@ -0,0 +1,760 @@
+#include "proj_solver.h"
+
+// third party
+#include "windows.h"
+
+
+// -- Transposition Table
+void tt_init(TransTable* tt, u8 log2_buckets, u8 log2_solutions) {
+    tt->bucket_mask   = (1u << log2_buckets) - 1;
+    tt->entries       = (TTEntry*) malloc(sizeof(TTEntry) * TT_WAYS * (u64(tt->bucket_mask) + 1));
+
+    tt->solution_mask = (1u << log2_solutions) - 1;
+    tt->solutions     = (TTSolution*) malloc(sizeof(TTSolution) * (u64(tt->solution_mask) + 1));
+
+    tt_clear(tt);
+}
+
+void tt_free(TransTable* tt) {
+    free(tt->entries);
+    free(tt->solutions);
+    tt->entries   = NULL;
+    tt->solutions = NULL;
+}
+
+void tt_clear(TransTable* tt) {
+    memset(tt->entries,   0, sizeof(TTEntry)    * TT_WAYS * (u64(tt->bucket_mask) + 1));
+    memset(tt->solutions, 0, sizeof(TTSolution) * (u64(tt->solution_mask) + 1));
+    tt->next_solution = 0;
+
+    tt->probes = 0;
+    tt->hits   = 0;
+    tt->stores = 0;
+}
+
+f32 tt_hit_rate(TransTable* tt) {
+    if (!tt->probes) return 0.0f;
+    return f32(tt->hits) / f32(tt->probes);
+}
+
+u8 _tt_probe(TransTable* tt, u64 hash, u64* data) {
+    tt->probes++;
+
+    TTEntry* bucket = &tt->entries[(hash & tt->bucket_mask) * TT_WAYS];
+    for (u8 w = 0; w < TT_WAYS; w++) {
+        u64 d = bucket[w].data;
+        u64 c = bucket[w].check;
+        if (d && (c ^ d) == hash) {
+            *data = d;
+            tt->hits++;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void _tt_store(TransTable* tt, u64 hash, u64 data) {
+    tt->stores++;
+
+    // reuse the matching way, then an empty way, otherwise a pseudo random one
+    TTEntry* bucket = &tt->entries[(hash & tt->bucket_mask) * TT_WAYS];
+    u8 target = u8(hash >> 62);
+    for (u8 w = 0; w < TT_WAYS; w++) {
+        u64 d = bucket[w].data;
+        if (!d) { target = w; continue; }
+        if ((bucket[w].check ^ d) == hash) { target = w; break; }
+    }
+
+    bucket[target].data  = data;
+    bucket[target].check = hash ^ data;
+}
+
+u32 _tt_keep_solution(TransTable* tt, u64 hash, u8* digits) {
+    u32 slot = u32(InterlockedIncrement(&tt->next_solution) - 1) & tt->solution_mask;
+
+    TTSolution* sol = &tt->solutions[slot];
+    sol->hash = 0;
+    memcpy(sol->digits, digits, BOARD_SIZE);
+    sol->hash = hash;
+
+    return slot + 1;
+}
+
+u8 _tt_fetch_solution(TransTable* tt, u64 hash, u32 slot, u8* digits) {
+    if (!slot) return 0;
+    TTSolution* sol = &tt->solutions[(slot - 1) & tt->solution_mask];
+    if (sol->hash != hash) return 0;
+    memcpy(digits, sol->digits, BOARD_SIZE);
+    return sol->hash == hash;
+}
+
+
+
+// -- Search State
+void _hash_bits(SearchState* s, u8 idx, u16 bits) {
+    while (bits) {
+        u16 bit = bits & (~bits + 1);
+        bits ^= bit;
+        s->hash ^= ZOBRIST(idx, BIT_DIGIT(bit) - 1);
+    }
+}
+
+void search_load(SearchState* s, u16* board) {
+    for (u8 i = 0; i < BOARD_SIZE; i++) {
+        u16 cell  = board[i];
+        u16 given = cell & BOARD_ALL;
+
+        // only inked digits are givens, pencil marks might be wrong
+        if (!given || ((cell & BOARD_FLAG_PENCIL) && !(cell & BOARD_FLAG_STATIC))) given = BOARD_ALL;
+
+        s->cells[i]  = given;
+        s->placed[i] = 0;
+    }
+    s->n_placed = 0;
+    s->hash     = search_hash(s);
+}
+
+u64 search_hash(SearchState* s) {
+    u64 hash = 0;
+    for (u8 i = 0; i < BOARD_SIZE; i++) {
+        for (u8 d = 0; d < 9; d++) {
+            if ((s->cells[i] >> d) & 0x1) hash ^= ZOBRIST(i, d);
+        }
+    }
+    return hash;
+}
+
+// old value of a cell about to change, only when searching through a context
+void _trail_push(SolverContext* ctx, SearchState* s, u8 idx) {
+    if (!ctx) return;
+    SolverTrail* t = &ctx->trail[ctx->n_trail++];
+    t->idx    = idx;
+    t->placed = s->placed[idx];
+    t->cells  = s->cells[idx];
+}
+
+// naked and hidden singles until nothing changes, returns 0 on a contradiction
+u8 _propagate(SearchState* s, SolverContext* ctx, SolverStats* stats) {
+    // cells down to one candidate and not placed yet, each goes on once
+    u8 singles[BOARD_SIZE];
+    u8 n_singles = 0;
+    for (u8 i = 0; i < BOARD_SIZE; i++) {
+        if (s->placed[i]) continue;
+        if (!s->cells[i]) return 0;
+        if (BIT_COUNT(s->cells[i]) == 1) singles[n_singles++] = i;
+    }
+    STAT_TECH(stats, runs, STAT_TECH_NAKED, 1);
+
+    while (1) {
+        // naked singles -- clear the digit from the 20 peers
+        while (n_singles) {
+            u8  i = singles[--n_singles];
+            u16 m = s->cells[i];
+
+            _trail_push(ctx, s, i);
+            s->placed[i] = 1;
+            s->n_placed++;
+            STAT_TECH(stats, placements, STAT_TECH_NAKED, 1);
+
+            u8 d = BIT_DIGIT(m) - 1;
+            for (u8 p = 0; p < N_PEERS; p++) {
+                u8 peer = CELL_PEERS(i)[p];
+                if (s->cells[peer] & m) {
+                    STAT_TECH(stats, eliminations, STAT_TECH_NAKED, 1);
+                    _trail_push(ctx, s, peer);
+                    s->cells[peer] &= ~m;
+                    s->hash ^= ZOBRIST(peer, d);
+                    if (!s->cells[peer]) return 0;
+                    if (BIT_COUNT(s->cells[peer]) == 1) singles[n_singles++] = peer;
+                }
+            }
+        }
+
+        // hidden singles -- digits with a single place left in a unit
+        STAT_TECH(stats, runs, STAT_TECH_HIDDEN, 1);
+        for (u8 u = 0; u < N_UNITS; u++) {
+            u16 once   = 0;
+            u16 twice  = 0;
+            u16 single = 0;
+            for (u8 k = 0; k < 9; k++) {
+                u16 m = s->cells[UNIT_CELLS(u)[k]];
+                twice  |= once & m;
+                once   |= m;
+                single |= m & -u16(BIT_COUNT(m) == 1);
+            }
+            if (once != BOARD_ALL) return 0;
+
+            // digits already down to a single cell have nothing left to clear
+            u16 hidden = once & ~twice & ~single;
+            while (hidden) {
+                u16 bit = hidden & (~hidden + 1);
+                hidden ^= bit;
+
+                for (u8 k = 0; k < 9; k++) {
+                    u8 idx = UNIT_CELLS(u)[k];
+                    if (!(s->cells[idx] & bit)) continue;
+
+                    STAT_TECH(stats, eliminations, STAT_TECH_HIDDEN, BIT_COUNT(s->cells[idx] & ~bit));
+                    STAT_TECH(stats, placements,   STAT_TECH_HIDDEN, 1);
+                    _hash_bits(s, idx, s->cells[idx] & ~bit);
+                    _trail_push(ctx, s, idx);
+                    s->cells[idx] = bit;
+                    singles[n_singles++] = idx;
+                    break;
+                }
+            }
+        }
+        if (!n_singles) break;
+    }
+
+    return 1;
+}
+
+u8 search_propagate(SearchState* s, SolverStats* stats) {
+    STAT_BEGIN(stats, STAT_STAGE_PROPAGATE);
+    u8 result = _propagate(s, NULL, stats);
+    STAT_END(stats, STAT_STAGE_PROPAGATE);
+    return result;
+}
+
+// minimum remaining values
+u8 _pick_cell(SearchState* s) {
+    u8 best       = 0xFF;
+    u8 best_count = 10;
+    for (u8 i = 0; i < BOARD_SIZE; i++) {
+        u8 count = BIT_COUNT(s->cells[i]);
+        if (count > 1 && count < best_count) {
+            best       = i;
+            best_count = count;
+            if (count == 2) break;
+        }
+    }
+    return best;
+}
+
+
+
+// -- Search
+/*
+    counts solutions of s up to limit, the first solution found is kept in
+    digits (if not NULL). only search_solve recurses, counting goes through
+    a context. a state is only looked up / stored after
+    propagation, so the hash identifies the deduced candidate state.
+    node and depth stats are kept by the caller, around the recursion.
+*/
+u32 _search(SearchState* s, u32 limit, TransTable* tt, u8* digits, u8* found, SolverStats* stats) {
+    if (!search_propagate(s, stats)) return 0;
+
+    if (s->n_placed == BOARD_SIZE) {
+        if (digits && !*found) {
+            for (u8 i = 0; i < BOARD_SIZE; i++) digits[i] = BIT_DIGIT(s->cells[i]);
+            *found = 1;
+        }
+        return 1;
+    }
+
+    if (tt) {
+        u64 data;
+        if (_tt_probe(tt, s->hash, &data)) {
+            u32 count = TT_COUNT(data);
+            u8  need  = digits && !*found;
+
+            // dead end, or enough solutions and nothing left to fetch
+            if (TT_KIND(data) == TT_EXACT && count == 0) return 0;
+            if (!need && (TT_KIND(data) == TT_EXACT || count >= limit)) {
+                return (count < limit) ? count : limit;
+            }
+            if (need && count >= limit && _tt_fetch_solution(tt, s->hash, TT_SLOT(data), digits)) {
+                *found = 1;
+                return limit;
+            }
+            if (need && TT_KIND(data) == TT_EXACT && _tt_fetch_solution(tt, s->hash, TT_SLOT(data), digits)) {
+                *found = 1;
+                return (count < limit) ? count : limit;
+            }
+        }
+    }
+
+    u8  idx        = _pick_cell(s);
+    u16 candidates = s->cells[idx];
+    u8  had_found  = found ? *found : 1;
+
+    u32 total = 0;
+    while (candidates && total < limit) {
+        u16 bit = candidates & (~candidates + 1);
+        candidates ^= bit;
+
+        SearchState next = *s;
+        _hash_bits(&next, idx, next.cells[idx] & ~bit);
+        next.cells[idx] = bit;
+
+        STAT_INC(stats, guesses);
+        STAT_ENTER(stats);
+        u32 count = _search(&next, limit - total, tt, digits, found, stats);
+        STAT_LEAVE(stats);
+        if (!count) STAT_INC(stats, backtracks);
+        total += count;
+    }
+
+    if (tt) {
+        u8  kind = (total < limit) ? TT_EXACT : TT_LOWER;
+        u32 slot = 0;
+
+        // keep the solution found under this state, for repeated solves
+        if (digits && !had_found && *found) {
+            slot = _tt_keep_solution(tt, s->hash, digits);
+        }
+        _tt_store(tt, s->hash, TT_DATA(kind, total, slot));
+    }
+
+    return total;
+}
+
+u8 search_solve(u16* board, TransTable* tt, SolverStats* stats) {
+    STAT_BEGIN(stats, STAT_STAGE_SEARCH);
+    SearchState s;
+    search_load(&s, board);
+
+    u8 digits[BOARD_SIZE];
+    u8 found = 0;
+    STAT_ENTER(stats);
+    _search(&s, 1, tt, digits, &found, stats);
+    STAT_LEAVE(stats);
+    STAT_END(stats, STAT_STAGE_SEARCH);
+    if (!found) return 0;
+
+    for (u8 i = 0; i < BOARD_SIZE; i++) {
+        if (board[i] & BOARD_FLAG_STATIC) continue;
+        board[i] = (board[i] & BOARD_FLAGS & ~u16(BOARD_FLAG_PENCIL)) | (1 << (digits[i] - 1));
+    }
+    return 1;
+}
+
+// -- Solver Context
+void solver_load(SolverContext* ctx, u16* board) {
+    search_load(&ctx->state, board);
+    ctx->depth   = 0;
+    ctx->n_trail = 0;
+}
+
+void solver_set(SolverContext* ctx, u8 idx, u16 candidates) {
+    SearchState* s = &ctx->state;
+    _hash_bits(s, idx, s->cells[idx] ^ candidates);
+    s->cells[idx] = candidates;
+}
+
+void _solver_unwind(SolverContext* ctx, u16 mark) {
+    SearchState* s = &ctx->state;
+    while (ctx->n_trail > mark) {
+        SolverTrail* t = &ctx->trail[--ctx->n_trail];
+        s->cells[t->idx]  = t->cells;
+        s->placed[t->idx] = t->placed;
+    }
+}
+
+// the next untried digit of the deepest frame that has one, 0 once the tree is done.
+// a frame that runs out has counted its whole subtree
+u8 _solver_branch(SolverContext* ctx, u32 total, SolverStats* stats) {
+    while (ctx->depth && !ctx->frames[ctx->depth - 1].candidates) {
+        SolverFrame* done = &ctx->frames[--ctx->depth];
+        if (ctx->tt) _tt_store(ctx->tt, done->hash, TT_DATA(TT_EXACT, total - done->total, 0));
+        STAT_LEAVE(stats);
+    }
+    if (!ctx->depth) return 0;
+
+    SearchState* s = &ctx->state;
+    SolverFrame* f = &ctx->frames[ctx->depth - 1];
+    _solver_unwind(ctx, f->mark);
+    s->n_placed = f->n_placed;
+    s->hash     = f->hash;
+
+    u16 bit = f->candidates & (~f->candidates + 1);
+    f->candidates ^= bit;
+
+    STAT_INC(stats, guesses);
+    _hash_bits(s, f->idx, s->cells[f->idx] & ~bit);
+    _trail_push(ctx, s, f->idx);
+    s->cells[f->idx] = bit;
+    return 1;
+}
+
+u32 solver_count(SolverContext* ctx, u32 limit, SolverStats* stats) {
+    STAT_BEGIN(stats, STAT_STAGE_SEARCH);
+    SearchState* s = &ctx->state;
+    u32 total = 0;
+
+    // the state is left where the search stopped, loading resets it
+    u8 live = 1;
+    while (live) {
+        STAT_BEGIN(stats, STAT_STAGE_PROPAGATE);
+        u8 ok = _propagate(s, ctx, stats);
+        STAT_END(stats, STAT_STAGE_PROPAGATE);
+
+        u64 data;
+        if (!ok) {
+            STAT_INC(stats, backtracks);
+        } else if (s->n_placed == BOARD_SIZE) {
+            if (!total) {
+                for (u8 i = 0; i < BOARD_SIZE; i++) ctx->digits[i] = BIT_DIGIT(s->cells[i]);
+            }
+            if (++total >= limit) break;
+        } else if (ctx->tt && _tt_probe(ctx->tt, s->hash, &data) && TT_KIND(data) == TT_EXACT &&
+                   (!TT_COUNT(data) || (total && total + TT_COUNT(data) < limit))) {
+            // nothing under it that has to be visited
+            total += TT_COUNT(data);
+            if (!TT_COUNT(data)) STAT_INC(stats, backtracks);
+        } else {
+            SolverFrame* f = &ctx->frames[ctx->depth++];
+            f->idx        = _pick_cell(s);
+            f->candidates = s->cells[f->idx];
+            f->mark       = ctx->n_trail;
+            f->n_placed   = s->n_placed;
+            f->hash       = s->hash;
+            f->total      = total;
+            STAT_ENTER(stats);
+        }
+        live = _solver_branch(ctx, total, stats);
+    }
+    for (; ctx->depth; ctx->depth--) STAT_LEAVE(stats);
+
+    STAT_END(stats, STAT_STAGE_SEARCH);
+    return total;
+}
+
+u32 count_solutions(u16* board, u32 limit, TransTable* tt, SolverStats* stats) {
+    SolverContext ctx;
+    solver_load(&ctx, board);
+    ctx.tt = tt;
+    return solver_count(&ctx, limit, stats);
+}
+
+u8 solver_solve(SolverContext* ctx, u16* board, SolverStats* stats) {
+    solver_load(ctx, board);
+    if (!solver_count(ctx, 1, stats)) return 0;
+
+    for (u8 i = 0; i < BOARD_SIZE; i++) {
+        if (board[i] & BOARD_FLAG_STATIC) continue;
+        board[i] = (board[i] & BOARD_FLAGS & ~u16(BOARD_FLAG_PENCIL)) | (1 << (ctx->digits[i] - 1));
+    }
+    return 1;
+}
+
+
+
+// -- Minimality
+struct _MinimalJob {
+    ThreadPool*   pool;
+    SearchState   base;                 // the puzzle as given, nothing propagated
+    u8            solution[BOARD_SIZE];
+    u8            clues[BOARD_SIZE];
+    u8            first_only;
+    TransTable*   tt;
+    SolverStats*  stats;                // one per worker, NULL without stats
+
+    u8*           redundant;
+    volatile long n_redundant;
+};
+
+void _check_clue(void* args, u32 index, u32 worker) {
+    _MinimalJob* job = (_MinimalJob*) args;
+    u8  idx   = job->clues[index];
+    u16 other = BOARD_ALL & ~u16(1 << (job->solution[idx] - 1));
+
+    // drop the clue and forbid its digit, any solution left is a second one
+    SolverContext ctx;
+    ctx.state = job->base;
+    ctx.tt    = job->tt;
+    solver_set(&ctx, idx, other);
+    if (solver_count(&ctx, 1, job->stats ? &job->stats[worker] : NULL)) return;
+
+    job->redundant[InterlockedIncrement(&job->n_redundant) - 1] = idx;
+    if (job->first_only && job->pool) pool_cancel(job->pool);
+}
+
+// pool_run blocks, so the job and every worker's context can live on the stack
+u8 check_minimal(u16* board, ThreadPool* pool, u8* redundant, u8 first_only, TransTable* tt, SolverStats* stats) {
+    _MinimalJob  job_data;
+    _MinimalJob* job = &job_data;
+    job->pool        = pool;
+    job->first_only  = first_only;
+    job->tt          = tt;
+    job->stats       = NULL;
+    job->redundant   = redundant;
+    job->n_redundant = 0;
+    search_load(&job->base, board);
+
+    // the solution, and that it's the only one
+    SolverContext ctx;
+    ctx.state = job->base;
+    ctx.tt    = tt;
+    if (solver_count(&ctx, 2, stats) != 1) return MINIMAL_NOT_UNIQUE;
+    memcpy(job->solution, ctx.digits, BOARD_SIZE);
+
+    u8 n_clues = 0;
+    for (u8 i = 0; i < BOARD_SIZE; i++) {
+        if (board[i] & BOARD_FLAG_STATIC) job->clues[n_clues++] = i;
+    }
+
+    u32 n_workers = pool ? pool->n_threads : 1;
+    if (stats) {
+        job->stats = (SolverStats*) malloc(sizeof(SolverStats) * n_workers);
+        for (u32 w = 0; w < n_workers; w++) stats_reset(&job->stats[w]);
+    }
+
+    if (pool) pool_run(pool, _check_clue, job, n_clues);
+    else {
+        for (u8 i = 0; i < n_clues; i++) {
+            _check_clue(job, i, 0);
+            if (first_only && job->n_redundant) break;
+        }
+    }
+
+    if (job->stats) {
+        for (u32 w = 0; w < n_workers; w++) stats_merge(stats, &job->stats[w]);
+        free(job->stats);
+    }
+
+    // workers finish in any order
+    u8 n = u8(job->n_redundant);
+    for (u8 i = 1; i < n; i++) {
+        u8 v = redundant[i];
+        u8 j = i;
+        for (; j > 0 && redundant[j - 1] > v; j--) redundant[j] = redundant[j - 1];
+        redundant[j] = v;
+    }
+
+    return n;
+}
+
+
+
+// -- Symmetric Search
+#define SYMMETRY_MAX_DEPTH      (BOARD_SIZE + 1)
+
+void symmetry_init(SymmetryWork* work) {
+    canon_init(&work->canon);
+    work->group    = (Canon*) malloc(sizeof(Canon));
+    work->members  = (u16*) malloc(sizeof(u16) * 2 * CANON_MAX_AUTOMORPHISMS * SYMMETRY_MAX_DEPTH);
+    work->orbits   = (Transform*) malloc(sizeof(Transform) * 9 * SYMMETRY_MAX_DEPTH);
+    work->n_orbits = (u8*) malloc(SYMMETRY_MAX_DEPTH);
+}
+
+void symmetry_free(SymmetryWork* work) {
+    canon_free(&work->canon);
+    free(work->group);
+    free(work->members);
+    free(work->orbits);
+    free(work->n_orbits);
+    work->group    = NULL;
+    work->members  = NULL;
+    work->orbits   = NULL;
+    work->n_orbits = NULL;
+}
+
+// steps a to the next permutation in lexicographic order, 0 after the last
+u8 _next_permutation(u8* a, u8 n) {
+    if (n < 2) return 0;
+    i8 i = n - 2;
+    while (i >= 0 && a[i] >= a[i + 1]) i--;
+    if (i < 0) return 0;
+
+    u8 j = n - 1;
+    while (a[j] <= a[i]) j--;
+    u8 tmp = a[i]; a[i] = a[j]; a[j] = tmp;
+    for (u8 l = i + 1, r = n - 1; l < r; l++, r--) {
+        tmp = a[l]; a[l] = a[r]; a[r] = tmp;
+    }
+    return 1;
+}
+
+struct _SymmetryRun {
+    SymmetryWork*    work;
+    SolutionCallback emit;
+    u8               expand;
+    void*            user;
+
+    u16              n_group;
+    u64              orbit_sum;   // sum of weight * |solution stabilizer|
+    u64              representatives;
+    SolverStats*     stats;
+};
+
+// emits t1(t2(..tk(digits))) for every choice of transversal along the path
+void _expand_orbits(_SymmetryRun* run, u8 depth, u8* digits) {
+    if (!depth) {
+        run->emit(digits, 1, run->user);
+        return;
+    }
+
+    Transform* level = &run->work->orbits[(depth - 1) * 9];
+    for (u8 i = 0; i < run->work->n_orbits[depth - 1]; i++) {
+        u8 image[BOARD_SIZE];
+        apply_transform(&level[i], digits, image);
+        _expand_orbits(run, depth - 1, image);
+    }
+}
+
+/*
+    group holds the automorphisms fixing every branch taken so far, they
+    also fix the propagated state since propagation doesn't care about labels
+*/
+u64 _search_symmetric(SearchState* s, u16* group, u16 n_group, u64 limit, _SymmetryRun* run, u8 depth, u64 weight) {
+    if (!search_propagate(s, run->stats)) return 0;
+
+    if (s->n_placed == BOARD_SIZE) {
+        u8 digits[BOARD_SIZE];
+        for (u8 i = 0; i < BOARD_SIZE; i++) digits[i] = BIT_DIGIT(s->cells[i]);
+
+        // the solution's stabilizer can be larger than the subgroup fixing
+        // the path, an automorphism may move branch cells onto each other
+        Transform* automorphisms = run->work->group->automorphisms;
+        u16 n_fixed = 0;
+        for (u16 g = 0; g < run->n_group; g++) {
+            u8 i = 0;
+            while (i < BOARD_SIZE && automorphisms[g].digits[digits[automorphisms[g].cells[i]]] == digits[i]) i++;
+            if (i == BOARD_SIZE) n_fixed++;
+        }
+        run->orbit_sum += weight * n_fixed;
+        run->representatives++;
+
+        if (run->emit) {
+            if (run->expand) _expand_orbits(run, depth, digits);
+            else             run->emit(digits, weight, run->user);
+        }
+        return 1;
+    }
+
+    Transform* automorphisms = run->work->group->automorphisms;
+    u8 idx = _pick_cell(s);
+
+    // stabilizer of the branch cell
+    u16* stab   = group + n_group;
+    u16  n_stab = 0;
+    for (u16 g = 0; g < n_group; g++) {
+        if (automorphisms[group[g]].cells[idx] == idx) stab[n_stab++] = group[g];
+    }
+    u16* child = stab + n_stab;
+
+    u16 candidates = s->cells[idx];
+    u16 done       = 0;
+    u64 total      = 0;
+
+    while (candidates && total < limit) {
+        u16 bit = candidates & (~candidates + 1);
+        candidates ^= bit;
+        if (done & bit) continue;
+
+        u8 d = BIT_DIGIT(bit);
+
+        // orbit of d, closing over the stabilizer, with the transversal if expanding
+        Transform* trans = &run->work->orbits[depth * 9];
+        u8  members[9];
+        u8  n_members = 1;
+        members[0]    = d;
+        done         |= bit;
+        if (run->expand) identity_transform(&trans[0]);
+
+        for (u8 m = 0; m < n_members; m++) {
+            for (u16 g = 0; g < n_stab; g++) {
+                u8  image     = automorphisms[stab[g]].digits[members[m]];
+                u16 image_bit = 1 << (image - 1);
+                if (done & image_bit) continue;
+
+                done |= image_bit;
+                if (run->expand) compose_transform(&automorphisms[stab[g]], &trans[m], &trans[n_members]);
+                members[n_members++] = image;
+            }
+        }
+        run->work->n_orbits[depth] = n_members;
+
+        // automorphisms that also fix the digit
+        u16 n_child = 0;
+        for (u16 g = 0; g < n_stab; g++) {
+            if (automorphisms[stab[g]].digits[d] == d) child[n_child++] = stab[g];
+        }
+
+        SearchState next = *s;
+        _hash_bits(&next, idx, next.cells[idx] & ~bit);
+        next.cells[idx] = bit;
+
+        // rounded up, without overflowing a limit of ~0
+        u64 left      = limit - total;
+        u64 remaining = left / n_members + (left % n_members != 0);
+        STAT_INC(run->stats, guesses);
+        STAT_ENTER(run->stats);
+        u64 count = _search_symmetric(&next, child, n_child, remaining, run, depth + 1, weight * n_members);
+        STAT_LEAVE(run->stats);
+        if (!count) STAT_INC(run->stats, backtracks);
+        total += n_members * count;
+    }
+
+    return total;
+}
+
+u64 search_symmetric(u16* board, u64 limit, SymmetryWork* work, 
+                     SolutionCallback emit, u8 expand, void* user, OrbitCount* out, SolverStats* stats) {
+    STAT_BEGIN(stats, STAT_STAGE_SEARCH);
+    u8 digits[BOARD_SIZE];
+    board_to_digits(board, digits);
+
+    STAT_BEGIN(stats, STAT_STAGE_CANON);
+    canonicalize(&work->canon, digits, work->group);
+    STAT_END(stats, STAT_STAGE_CANON);
+
+    // a truncated group isn't closed, but any automorphism still maps
+    // counts onto counts, so the kept ones are safe to prune with
+    u64 group_size = work->group->n_automorphisms;
+    u16 n_group    = u16(group_size);
+    if (group_size > CANON_MAX_AUTOMORPHISMS) n_group = CANON_MAX_AUTOMORPHISMS;
+
+    // canonicalize gives digits missing from the clues fixed labels, every
+    // relabeling among them is an automorphism as well
+    u8 absent[9];
+    u8 n_absent = 0;
+    u16 present = 0;
+    for (u8 i = 0; i < BOARD_SIZE; i++) if (digits[i]) present |= 1 << (digits[i] - 1);
+    for (u8 d = 1; d < 10; d++) if (!(present & (1 << (d - 1)))) absent[n_absent++] = d;
+
+    u16 n_base = n_group;
+    u8  perm[9];
+    for (u8 k = 0; k < n_absent; k++) perm[k] = k;
+    while (_next_permutation(perm, n_absent)) {
+        group_size += work->group->n_automorphisms;
+        for (u16 g = 0; g < n_base && n_group < CANON_MAX_AUTOMORPHISMS; g++) {
+            Transform* base = &work->group->automorphisms[g];
+            Transform* t    = &work->group->automorphisms[n_group++];
+            *t = *base;
+            for (u8 k = 0; k < n_absent; k++) {
+                for (u8 d = 1; d < 10; d++) {
+                    if (base->digits[d] == absent[k]) t->digits[d] = absent[perm[k]];
+                }
+            }
+        }
+    }
+    for (u16 g = 0; g < n_group; g++) work->members[g] = g;
+
+    _SymmetryRun run;
+    run.work            = work;
+    run.emit            = emit;
+    run.expand          = expand;
+    run.user            = user;
+    run.n_group         = n_group;
+    run.orbit_sum       = 0;
+    run.representatives = 0;
+    run.stats           = stats;
+
+    SearchState s;
+    search_load(&s, board);
+    STAT_ENTER(stats);
+    u64 total = _search_symmetric(&s, work->members, n_group, limit, &run, 0, 1);
+    STAT_LEAVE(stats);
+    STAT_END(stats, STAT_STAGE_SEARCH);
+
+    if (out) {
+        out->solutions       = total;
+        out->representatives = run.representatives;
+        out->group_size      = group_size;
+        out->orbits          = (n_group == group_size) ? run.orbit_sum / n_group : 0;
+    }
+    return total;
+}
@@ -0,0 +1,226 @@
+#ifndef PROJ_SOLVER_H
+#define PROJ_SOLVER_H
+
+// local
+#include "proj_types.h"
+#include "proj_board.h"
+#include "proj_canon.h"
+#include "proj_pool.h"
+#include "proj_rand.h"
+
+// system
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+
+
+/*
+    zobrist keys, one per (cell, digit) candidate
+
+    the hash of a search state is the xor of the keys of every candidate
+    still present, so a placement or elimination is a single xor per
+    removed candidate.
+*/
+struct ZobristKeys {
+    u64 keys[BOARD_SIZE][9];
+};
+
+constexpr ZobristKeys build_zobrist_keys() {
+    ZobristKeys z = {};
+    u64 state = 0x5D0C0B0A2D1E5EEDull;
+    for (u32 i = 0; i < BOARD_SIZE; i++) {
+        for (u32 d = 0; d < 9; d++) {
+            z.keys[i][d] = _rng_splitmix(&state);
+        }
+    }
+    return z;
+}
+
+constexpr ZobristKeys zobrist = build_zobrist_keys();
+
+#define ZOBRIST(i, d)     (zobrist.keys[i][d])
+
+
+/*
+    transposition table
+
+    fixed size and set associative, TT_WAYS entries per bucket. entries are
+    written without locks, each stores (hash ^ data) next to data so a torn
+    write simply fails to match on the next probe.
+
+    data layout
+        [ 0, 2)  kind  -- TT_EXACT: count is the full solution count
+                          TT_LOWER: count is a lower bound
+        [ 2,34)  count
+        [34,64)  solution slot + 1, 0 if no solution was kept
+*/
+#define TT_WAYS             4
+#define TT_EXACT            0x1
+#define TT_LOWER            0x2
+
+#define TT_KIND(d)          u8((d) & 0x3)
+#define TT_COUNT(d)         u32(((d) >> 2) & 0xFFFFFFFF)
+#define TT_SLOT(d)          u32((d) >> 34)
+#define TT_DATA(k, c, s)    (u64(k) | (u64(c) << 2) | (u64(s) << 34))
+
+struct TTEntry {
+    u64 check;
+    u64 data;
+};
+
+struct TTSolution {
+    u64 hash;
+    u8  digits[BOARD_SIZE];
+};
+
+struct TransTable {
+    u32         bucket_mask    = 0;
+    TTEntry*    entries        = NULL;
+
+    u32         solution_mask  = 0;
+    TTSolution* solutions      = NULL;
+    volatile long next_solution = 0;
+
+    // metrics, updated without synchronisation
+    u64         probes         = 0;
+    u64         hits           = 0;
+    u64         stores         = 0;
+};
+
+void tt_init(TransTable* tt, u8 log2_buckets, u8 log2_solutions);
+void tt_free(TransTable* tt);
+void tt_clear(TransTable* tt);
+f32  tt_hit_rate(TransTable* tt);
+
+
+/*
+    search solver
+
+    cells hold candidate masks only, the u16 board flags are dropped when a
+    state is loaded and restored when a solution is written back.
+*/
+struct SearchState {
+    u16 cells[BOARD_SIZE];
+    u8  placed[BOARD_SIZE];   // peers have been cleared of this cell's digit
+    u8  n_placed;
+    u64 hash;
+};
+
+void search_load(SearchState* s, u16* board);
+u64  search_hash(SearchState* s);
+u8   search_propagate(SearchState* s, SolverStats* stats);
+
+// writes the solution into the non static cells, returns 0 if there is none
+u8   search_solve(u16* board, TransTable* tt, SolverStats* stats);
+
+// counts solutions up to limit, solver_count on a context of its own
+u32  count_solutions(u16* board, u32 limit, TransTable* tt, SolverStats* stats);
+
+
+/*
+    solver context -- a search that never touches the heap
+
+    the search runs on an explicit stack of branch frames instead of
+    copying the state per level. cells are changed in place, the old value
+    of every changed cell goes on the trail, and a backtrack unwinds the
+    trail to the frame's mark. a branch fixes a cell, so the depth is at
+    most one frame per cell, and on one path a cell loses at most 8
+    candidates and is placed once, which bounds the trail.
+
+    all of it lives in the struct, sized up front. keep one per thread
+    (pool tasks can index them by worker) and load a puzzle into it as
+    often as needed.
+
+    with a table the count skips states the table knows are dead ends,
+    and states with a known count once the first solution is kept and the
+    count can't reach the limit, so ctx->digits and the state a count stops
+    on are always real solutions. a branch that runs out stores its exact
+    count. the table can be shared by every context.
+*/
+#define SOLVER_MAX_DEPTH        BOARD_SIZE
+#define SOLVER_MAX_TRAIL        (BOARD_SIZE * 9)
+
+struct SolverTrail {
+    u8  idx;
+    u8  placed;
+    u16 cells;
+};
+
+struct SolverFrame {
+    u8  idx;                // branch cell
+    u16 candidates;         // digits of it not tried yet
+    u16 mark;               // trail length before the branch
+    u8  n_placed;
+    u64 hash;
+    u32 total;              // solutions counted before the branch
+};
+
+struct SolverContext {
+    SearchState state;
+    SolverFrame frames[SOLVER_MAX_DEPTH];
+    SolverTrail trail[SOLVER_MAX_TRAIL];
+    u8          depth   = 0;
+    u16         n_trail = 0;
+    u8          digits[BOARD_SIZE];     // first solution of the last run
+    TransTable* tt      = NULL;         // not owned
+};
+
+void solver_load(SolverContext* ctx, u16* board);
+void solver_set(SolverContext* ctx, u8 idx, u16 candidates);     // overrides a loaded cell
+
+// counts solutions of the loaded puzzle up to limit, the first one is kept in ctx->digits
+u32  solver_count(SolverContext* ctx, u32 limit, SolverStats* stats);
+
+// search_solve without a table, through ctx
+u8   solver_solve(SolverContext* ctx, u16* board, SolverStats* stats);
+
+
+/*
+    minimality -- a static clue is redundant if the puzzle stays unique
+    without it, ie no solution puts another digit in its cell. every clue
+    is one independent search, spread over the pool (NULL runs them here).
+    with first_only the search stops at the first redundant clue found.
+    the searches share tt if there is one. each worker counts into stats
+    of its own, merged into stats at the end.
+*/
+#define MINIMAL_NOT_UNIQUE      0xFF
+
+// writes the redundant clues in index order, returns how many
+u8   check_minimal(u16* board, ThreadPool* pool, u8* redundant, u8 first_only, TransTable* tt, SolverStats* stats);
+
+
+/*
+    symmetry aware search
+
+    the automorphisms of the clue set map solutions onto solutions. at each
+    branch only one digit per orbit of the branch cell's stabilizer is
+    searched, its count standing in for the whole orbit. a representative
+    carries a weight, the number of solutions it stands for, and can be
+    expanded back into them on output.
+*/
+typedef void (*SolutionCallback)(u8* digits, u64 weight, void* user);
+
+struct SymmetryWork {
+    CanonWork  canon;
+    Canon*     group    = NULL;   // automorphisms of the loaded clues
+    u16*       members  = NULL;   // subgroup index lists, stacked per depth
+    Transform* orbits   = NULL;   // transversal per depth and digit, for expansion
+    u8*        n_orbits = NULL;
+};
+
+struct OrbitCount {
+    u64 solutions;          // every orbit expanded
+    u64 orbits;             // solutions up to symmetry, 0 if the group was truncated
+    u64 representatives;    // leaves actually searched
+    u64 group_size;
+};
+
+void symmetry_init(SymmetryWork* work);
+void symmetry_free(SymmetryWork* work);
+
+// emit may be NULL, with expand every solution is emitted once with weight 1
+u64  search_symmetric(u16* board, u64 limit, SymmetryWork* work, 
+                      SolutionCallback emit, u8 expand, void* user, OrbitCount* out, SolverStats* stats);
+
+#endif
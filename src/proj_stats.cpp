@@ -0,0 +1,68 @@
+#include "proj_stats.h"
+
+// third party
+#include "windows.h"
+
+
+// -- Stats
+void stats_reset(SolverStats* stats) {
+    memset(stats, 0, sizeof(SolverStats));
+}
+
+void stats_merge(SolverStats* into, SolverStats* from) {
+    for (u8 t = 0; t < N_STAT_TECHS; t++) {
+        into->runs[t]         += from->runs[t];
+        into->eliminations[t] += from->eliminations[t];
+        into->placements[t]   += from->placements[t];
+    }
+
+    into->nodes      += from->nodes;
+    into->guesses    += from->guesses;
+    into->backtracks += from->backtracks;
+    if (from->max_depth > into->max_depth) into->max_depth = from->max_depth;
+
+    for (u8 s = 0; s < N_STAT_STAGES; s++) {
+        into->calls[s] += from->calls[s];
+        into->ns[s]    += from->ns[s];
+    }
+}
+
+void stats_print(SolverStats* stats) {
+    const char* techs[N_STAT_TECHS]   = {"square", "row", "col", "region", "naked", "hidden", "box-line", "subset"};
+    const char* stages[N_STAT_STAGES] = {"progress", "fast", "propagate", "search", "canon", "logic"};
+
+    printf("[Stats] %-10s %12s %12s %12s\n", "technique", "runs", "eliminated", "placed");
+    for (u8 t = 0; t < N_STAT_TECHS; t++) {
+        printf("[Stats] %-10s %12llu %12llu %12llu\n", techs[t],
+               stats->runs[t], stats->eliminations[t], stats->placements[t]);
+    }
+
+    printf("[Stats] nodes %llu  guesses %llu  backtracks %llu  max depth %u\n",
+           stats->nodes, stats->guesses, stats->backtracks, stats->max_depth);
+
+    for (u8 s = 0; s < N_STAT_STAGES; s++) {
+        if (!stats->calls[s]) continue;
+        printf("[Stats] %-10s %8llu calls %12.3f ms %10.1f ns/call\n", stages[s], stats->calls[s],
+               f64(stats->ns[s]) / 1e6, f64(stats->ns[s]) / f64(stats->calls[s]));
+    }
+}
+
+
+// -- Timing
+u64 stats_ticks() {
+    LARGE_INTEGER t;
+    QueryPerformanceCounter(&t);
+    return u64(t.QuadPart);
+}
+
+u64 stats_ticks_to_ns(u64 ticks) {
+    static u64 freq = 0;
+    if (!freq) {
+        LARGE_INTEGER f;
+        QueryPerformanceFrequency(&f);
+        freq = u64(f.QuadPart);
+    }
+
+    // split to keep ticks * 1e9 from overflowing
+    return (ticks / freq) * 1000000000ull + ((ticks % freq) * 1000000000ull) / freq;
+}
@@ -0,0 +1,101 @@
+#ifndef PROJ_STATS_H
+#define PROJ_STATS_H
+
+// local
+#include "proj_types.h"
+
+// system
+#include "stdio.h"
+#include "string.h"
+
+
+
+/*
+    solver instrumentation
+
+    every solver entry point takes a SolverStats* (NULL to skip). counting
+    only happens when built with STATS_ENABLE, otherwise the STAT_ macros
+    do nothing and the pointer is never touched.
+
+    counters accumulate over calls, reset between runs if needed. one
+    struct per thread, stats_merge them once the threads are done.
+*/
+// a run is one step on a cell for the progressive ones, one unit for region
+// and one pass over the board for the rest
+#define STAT_TECH_SQUARE        0   // progressive, box + square rule
+#define STAT_TECH_ROW           1   // progressive, row
+#define STAT_TECH_COL           2   // progressive, col
+#define STAT_TECH_REGION        3   // fast_solve unit pass
+#define STAT_TECH_NAKED         4   // search and logic, naked single
+#define STAT_TECH_HIDDEN        5   // search and logic, hidden single
+#define STAT_TECH_BOX_LINE      6   // logic, pointing and claiming
+#define STAT_TECH_SUBSET        7   // logic, naked pairs and triples
+
+#define N_STAT_TECHS            8
+
+// stages nest, search time includes its propagation
+#define STAT_STAGE_PROGRESS     0
+#define STAT_STAGE_FAST         1
+#define STAT_STAGE_PROPAGATE    2
+#define STAT_STAGE_SEARCH       3
+#define STAT_STAGE_CANON        4
+#define STAT_STAGE_LOGIC        5
+
+#define N_STAT_STAGES           6
+
+struct SolverStats {
+    u64 runs[N_STAT_TECHS];           // times the technique was applied
+    u64 eliminations[N_STAT_TECHS];   // candidates removed
+    u64 placements[N_STAT_TECHS];     // cells set
+
+    u64 nodes;                        // search states entered
+    u64 guesses;                      // branches tried
+    u64 backtracks;                   // branches that led nowhere
+    u32 depth;
+    u32 max_depth;
+
+    u64 calls[N_STAT_STAGES];
+    u64 ns[N_STAT_STAGES];
+};
+
+void stats_reset(SolverStats* stats);
+void stats_merge(SolverStats* into, SolverStats* from);
+void stats_print(SolverStats* stats);
+
+u64  stats_ticks();
+u64  stats_ticks_to_ns(u64 ticks);
+
+
+#ifdef STATS_ENABLE
+    #define STAT_ADD(st, field, n)      { if (st) (st)->field += (n); }
+    #define STAT_INC(st, field)         STAT_ADD(st, field, 1)
+    #define STAT_TECH(st, field, t, n)  STAT_ADD(st, field[t], n)
+
+    #define STAT_ENTER(st) {\
+        if (st) {\
+            (st)->nodes++;\
+            (st)->depth++;\
+            if ((st)->depth > (st)->max_depth) (st)->max_depth = (st)->depth;\
+        }\
+    }
+    #define STAT_LEAVE(st)              { if (st) (st)->depth--; }
+
+    #define STAT_BEGIN(st, stage)       u64 _stat_start_##stage = (st) ? stats_ticks() : 0
+    #define STAT_END(st, stage) {\
+        if (st) {\
+            (st)->calls[stage]++;\
+            (st)->ns[stage] += stats_ticks_to_ns(stats_ticks() - _stat_start_##stage);\
+        }\
+    }
+#else
+    // a statement, not nothing, so an if around one still has a body
+    #define STAT_ADD(st, field, n)      ((void)0)
+    #define STAT_INC(st, field)         ((void)0)
+    #define STAT_TECH(st, field, t, n)  ((void)0)
+    #define STAT_ENTER(st)              ((void)0)
+    #define STAT_LEAVE(st)              ((void)0)
+    #define STAT_BEGIN(st, stage)       ((void)0)
+    #define STAT_END(st, stage)         ((void)0)
+#endif
+
+#endif
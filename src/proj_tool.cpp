@@ -0,0 +1,363 @@
+/*
+    headless tools, built with build.bat -tool into sudoku_tool.exe
+
+    sudoku_tool lowclue [options]
+        -clues n        puzzles of at most n givens (default 20)
+        -seed s         grids of the search (default from the clock)
+        -nodes n        node budget per grid
+        -hours h        stop after h hours (default runs until stopped)
+        -threads n      0 for one per processor (default)
+        -out path       puzzles are appended here (default lowclue.txt)
+        -checkpoint p   progress, a search resumes from it (default lowclue.chk).
+                        -clues, -seed and -nodes have to match it if given
+
+    sudoku_tool generate [options]
+        -count n        puzzles to write (default 1000)
+        -difficulty d   easy, medium, hard or expert, or 0-3 (default medium)
+        -symmetry s     none, rotate180, mirrorx, mirrory, diagonal, rotate90, or 0-5
+        -seed s         puzzle n is dug from stream n of the seed (default from the clock)
+        -budget us      time per puzzle before the closest one is taken, 0 counts
+                        grids instead so the same seed writes the same file
+        -threads n      0 for one per processor (default)
+        -out path       one 81 character line per puzzle, - for stdout (default puzzles.txt)
+
+    sudoku_tool count [options]
+        -puzzle p       81 characters, 1-9 for a clue, 0 or . for an empty cell
+                        (default the empty grid)
+        -in path        one puzzle per line instead, - for stdin
+        -method m       bands (default), or symmetric to search one solution per
+                        orbit of the clues' automorphisms, which adds the count
+                        up to symmetry
+        -threads n      0 for one per processor (default)
+
+    sudoku_tool canon [options]
+        -puzzle p       as for count, one puzzle
+        -in path        one puzzle per line, - for stdin (default)
+                        each is written as its minlex form and automorphism count
+*/
+
+// local
+#include "proj_types.h"
+#include "proj_board.h"
+#include "proj_pool.h"
+#include "proj_stats.h"
+#include "proj_lowclue.h"
+#include "proj_batch.h"
+#include "proj_count.h"
+#include "proj_solver.h"
+#include "proj_canon.h"
+
+// third party
+#include "windows.h"
+
+// system
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+
+
+// -- Arguments
+// the value after flag, NULL if flag isn't there
+const char* _tool_arg(int argc, char** argv, const char* flag) {
+    for (int i = 2; i + 1 < argc; i++) {
+        if (!strcmp(argv[i], flag)) return argv[i + 1];
+    }
+    return NULL;
+}
+
+// an index into names, by number or by name with spaces left out. n if neither
+u8 _tool_pick(const char* arg, const char* const* names, u8 n) {
+    if (arg[0] >= '0' && arg[0] <= '9') return u8(atoi(arg)) < n ? u8(atoi(arg)) : n;
+
+    for (u8 i = 0; i < n; i++) {
+        const char* a = arg;
+        const char* b = names[i];
+        while (*a && *b) {
+            if (*b == ' ') { b++; continue; }
+            if (*a != *b) break;
+            a++;
+            b++;
+        }
+        if (!*a && !*b) return i;
+    }
+    return n;
+}
+
+void _tool_usage() {
+    printf("usage: sudoku_tool lowclue [-clues n] [-seed s] [-nodes n] [-hours h] [-threads n] [-out path] [-checkpoint path]\n");
+    printf("       sudoku_tool generate [-count n] [-difficulty d] [-symmetry s] [-seed s] [-budget us] [-threads n] [-out path]\n");
+    printf("       sudoku_tool count [-puzzle p] [-in path] [-method m] [-threads n]\n");
+    printf("       sudoku_tool canon [-puzzle p] [-in path]\n");
+}
+
+// 81 cells of 1-9, 0 or ., anything else is skipped. 0 if there aren't 81
+u8 _tool_board(const char* text, u16* board) {
+    u8 n = 0;
+    for (; *text && *text != '\n' && n < BOARD_SIZE; text++) {
+        if (*text == '0' || *text == '.')     board[n++] = BOARD_EMPTY;
+        else if (*text >= '1' && *text <= '9') board[n++] = BOARD_FLAG_STATIC | (1 << (*text - '1'));
+    }
+    return n == BOARD_SIZE;
+}
+
+
+
+// -- Low clue
+int _tool_lowclue(int argc, char** argv) {
+    LowClueSearch search;
+
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    search.seed = u64(now.QuadPart);
+
+    const char* arg;
+    if ((arg = _tool_arg(argc, argv, "-clues")))      search.clues       = u8(atoi(arg));
+    if ((arg = _tool_arg(argc, argv, "-seed")))       search.seed        = strtoull(arg, NULL, 0);
+    if ((arg = _tool_arg(argc, argv, "-nodes")))      search.node_budget = strtoull(arg, NULL, 0);
+    if ((arg = _tool_arg(argc, argv, "-out")))        search.output      = arg;
+    if ((arg = _tool_arg(argc, argv, "-checkpoint"))) search.checkpoint  = arg;
+
+    f64 hours = 0;
+    u32 n_threads = 0;
+    if ((arg = _tool_arg(argc, argv, "-hours")))      hours     = atof(arg);
+    if ((arg = _tool_arg(argc, argv, "-threads")))    n_threads = u32(atoi(arg));
+
+    // a checkpoint is a search of its own clues, seed and budget, flags
+    // that ask for another one would be dropped without a word
+    LowClueSearch asked = search;
+    if (lowclue_load(&search)) {
+        const char* differs = NULL;
+        if (_tool_arg(argc, argv, "-clues") && asked.clues != search.clues)             differs = "-clues";
+        if (_tool_arg(argc, argv, "-seed")  && asked.seed != search.seed)               differs = "-seed";
+        if (_tool_arg(argc, argv, "-nodes") && asked.node_budget != search.node_budget) differs = "-nodes";
+        if (differs) {
+            printf("[Error] %s is a search of %u clues, seed %llu, %llu nodes per grid, %s asks for another.\n",
+                   search.checkpoint, search.clues, search.seed, search.node_budget, differs);
+            printf("[Error] leave %s out to resume it, or start a new one with -checkpoint\n", differs);
+            return 1;
+        }
+        printf("[LowClue] resuming %s :: batch %llu, %llu found so far\n", search.checkpoint, search.batches, search.found);
+    }
+    if (search.clues < 17 || search.clues > LOWCLUE_MAX_CLUES) {
+        printf("[Error] -clues has to be within [17, %u]\n", LOWCLUE_MAX_CLUES);
+        return 1;
+    }
+
+    ThreadPool pool;
+    pool_init(&pool, n_threads);
+    printf("[LowClue] %u clues, seed 0x%016llx, %u threads, writing %s\n", search.clues, search.seed, pool.n_threads, search.output);
+
+    lowclue_run(&search, &pool, u64(hours * 3600.0));
+    pool_free(&pool);
+    return 0;
+}
+
+
+
+// -- Generate
+int _tool_generate(int argc, char** argv) {
+    BatchJob job;
+    job.count = 1000;
+
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    job.seed = u64(now.QuadPart);
+
+    u8          difficulty = DIFFICULTY_MEDIUM;
+    u32         n_threads  = 0;
+    const char* path       = "puzzles.txt";
+
+    const char* arg;
+    if ((arg = _tool_arg(argc, argv, "-count")))      job.count     = u32(strtoul(arg, NULL, 0));
+    if ((arg = _tool_arg(argc, argv, "-difficulty"))) difficulty    = _tool_pick(arg, difficulty_names, N_DIFFICULTIES);
+    if ((arg = _tool_arg(argc, argv, "-symmetry")))   job.symmetry  = _tool_pick(arg, symmetry_names, N_SYMMETRIES);
+    if ((arg = _tool_arg(argc, argv, "-seed")))       job.seed      = strtoull(arg, NULL, 0);
+    if ((arg = _tool_arg(argc, argv, "-budget")))     job.budget_us = strtoull(arg, NULL, 0);
+    if ((arg = _tool_arg(argc, argv, "-threads")))    n_threads     = u32(atoi(arg));
+    if ((arg = _tool_arg(argc, argv, "-out")))        path          = arg;
+
+    if (difficulty == N_DIFFICULTIES || job.symmetry == N_SYMMETRIES) {
+        _tool_usage();
+        return 1;
+    }
+    if (job.count > 0x7FFFFFFF) job.count = 0x7FFFFFFF;
+    job.range = difficulty_ranges[difficulty];
+
+    job.out = strcmp(path, "-") ? fopen(path, "w") : stdout;
+    if (!job.out) {
+        printf("[Error] Couldn't open %s\n", path);
+        return 1;
+    }
+
+    ThreadPool pool;
+    pool_init(&pool, n_threads);
+    fprintf(stderr, "[Batch] %u %s puzzles, symmetry %s, seed 0x%016llx, %u threads\n",
+            job.count, difficulty_names[difficulty], symmetry_names[job.symmetry], job.seed, pool.n_threads);
+
+    batch_generate(&job, &pool);
+
+    f64 seconds = f64(stats_ticks_to_ns(job.ticks)) / 1e9;
+    fprintf(stderr, "[Batch] %u puzzles in %.2fs :: %.1f puzzles/s, %.1f per thread, %ld out of budget\n",
+            job.written, seconds, f64(job.written) / seconds, f64(job.written) / seconds / pool.n_threads, job.missed);
+#ifdef STATS_ENABLE
+    // stdout may be the puzzles
+    if (job.out != stdout) stats_print(&job.stats);
+#endif
+
+    pool_free(&pool);
+    if (job.out != stdout) fclose(job.out);
+    return 0;
+}
+
+
+
+// -- Count
+#define TOOL_COUNT_BANDS        0
+#define TOOL_COUNT_SYMMETRIC    1
+#define N_TOOL_COUNT_METHODS    2
+
+constexpr const char* tool_count_methods[N_TOOL_COUNT_METHODS] = {"bands", "symmetric"};
+
+void _tool_count_one(u16* board, u8 method, ThreadPool* pool, SymmetryWork* work) {
+    char line[BOARD_SIZE + 1];
+    for (u8 i = 0; i < BOARD_SIZE; i++) line[i] = '0' + BIT_DIGIT(board[i]);
+    line[BOARD_SIZE] = 0;
+
+    u64 start = stats_ticks();
+    if (method == TOOL_COUNT_SYMMETRIC) {
+        OrbitCount oc;
+        search_symmetric(board, ~0ull, work, NULL, 0, NULL, &oc, NULL);
+        f64 ms = f64(stats_ticks_to_ns(stats_ticks() - start)) / 1e6;
+
+        // a truncated group has no orbit count
+        if (oc.orbits) printf("%s %llu %llu\n", line, oc.solutions, oc.orbits);
+        else           printf("%s %llu -\n", line, oc.solutions);
+        fprintf(stderr, "[Count] group of %llu, %llu representatives searched, %.1f ms\n", oc.group_size, oc.representatives, ms);
+        return;
+    }
+
+    BandCount bc;
+    count_bands(board, pool, &bc);
+    f64 ms = f64(stats_ticks_to_ns(stats_ticks() - start)) / 1e6;
+
+    char text[48];
+    u128_to_string(bc.total, text);
+    printf("%s %s\n", line, text);
+    fprintf(stderr, "[Count] %u gangster classes, %llu top bands, %.1f ms\n", bc.n_gangsters, bc.n_top_bands, ms);
+}
+
+int _tool_count(int argc, char** argv) {
+    u16         board[BOARD_SIZE] = {0};
+    u32         n_threads = 0;
+    u8          method    = TOOL_COUNT_BANDS;
+    const char* path      = NULL;
+
+    const char* arg;
+    if ((arg = _tool_arg(argc, argv, "-threads"))) n_threads = u32(atoi(arg));
+    if ((arg = _tool_arg(argc, argv, "-in")))      path      = arg;
+    if ((arg = _tool_arg(argc, argv, "-method")))  method    = _tool_pick(arg, tool_count_methods, N_TOOL_COUNT_METHODS);
+    if (method == N_TOOL_COUNT_METHODS) {
+        _tool_usage();
+        return 1;
+    }
+    if ((arg = _tool_arg(argc, argv, "-puzzle")) && !_tool_board(arg, board)) {
+        printf("[Error] -puzzle needs 81 cells\n");
+        return 1;
+    }
+
+    FILE* in = NULL;
+    if (path) {
+        in = strcmp(path, "-") ? fopen(path, "r") : stdin;
+        if (!in) {
+            printf("[Error] Couldn't open %s\n", path);
+            return 1;
+        }
+    }
+
+    // the symmetric search runs on this thread alone
+    ThreadPool   pool;
+    SymmetryWork work;
+    pool_init(&pool, n_threads);
+    symmetry_init(&work);
+
+    if (!in) _tool_count_one(board, method, &pool, &work);
+    else {
+        char text[256];
+        while (fgets(text, sizeof(text), in)) {
+            if (_tool_board(text, board)) _tool_count_one(board, method, &pool, &work);
+        }
+        if (in != stdin) fclose(in);
+    }
+
+    symmetry_free(&work);
+    pool_free(&pool);
+    return 0;
+}
+
+
+
+// -- Canon
+void _tool_canon_one(u16* board, CanonWork* work, Canon* canon) {
+    u8 digits[BOARD_SIZE];
+    board_to_digits(board, digits);
+    canonicalize(work, digits, canon);
+
+    char line[BOARD_SIZE + 1];
+    for (u8 i = 0; i < BOARD_SIZE; i++) line[i] = '0' + canon->minlex[i];
+    line[BOARD_SIZE] = 0;
+    printf("%s %u\n", line, canon->n_automorphisms);
+}
+
+int _tool_canon(int argc, char** argv) {
+    u16         board[BOARD_SIZE];
+    const char* path = "-";
+
+    const char* arg;
+    if ((arg = _tool_arg(argc, argv, "-in"))) path = arg;
+    if ((arg = _tool_arg(argc, argv, "-puzzle"))) {
+        if (!_tool_board(arg, board)) {
+            printf("[Error] -puzzle needs 81 cells\n");
+            return 1;
+        }
+        path = NULL;
+    }
+
+    FILE* in = NULL;
+    if (path) {
+        in = strcmp(path, "-") ? fopen(path, "r") : stdin;
+        if (!in) {
+            printf("[Error] Couldn't open %s\n", path);
+            return 1;
+        }
+    }
+
+    CanonWork work;
+    canon_init(&work);
+    Canon* canon = (Canon*) malloc(sizeof(Canon));
+
+    if (!in) _tool_canon_one(board, &work, canon);
+    else {
+        char text[256];
+        while (fgets(text, sizeof(text), in)) {
+            if (_tool_board(text, board)) _tool_canon_one(board, &work, canon);
+        }
+        if (in != stdin) fclose(in);
+    }
+
+    free(canon);
+    canon_free(&work);
+    return 0;
+}
+
+
+
+int main(int argc, char** argv) {
+    if (argc >= 2 && !strcmp(argv[1], "lowclue"))  return _tool_lowclue(argc, argv);
+    if (argc >= 2 && !strcmp(argv[1], "generate")) return _tool_generate(argc, argv);
+    if (argc >= 2 && !strcmp(argv[1], "count"))    return _tool_count(argc, argv);
+    if (argc >= 2 && !strcmp(argv[1], "canon"))    return _tool_canon(argc, argv);
+
+    _tool_usage();
+    return 1;
+}
@@ -0,0 +1,137 @@
+#include "proj_unavoid.h"
+
+
+// -- Sets
+void ua_diff(const u8* grid, const u8* other, u64* mask) {
+    mask[0] = 0;
+    mask[1] = 0;
+    for (u8 i = 0; i < BOARD_SIZE; i++) {
+        if (grid[i] != other[i]) mask[i >> 6] |= 1ull << (i & 63);
+    }
+}
+
+u8 ua_add(Unavoidables* ua, const u64* mask) {
+    u8 size = mask_count(mask[0]) + mask_count(mask[1]);
+    if (!size) return 0;
+
+    for (u32 i = 0; i < ua->n_sets; i++) {
+        const u64* m = ua->masks[i];
+        if ((m[0] & mask[0]) == m[0] && (m[1] & mask[1]) == m[1]) return 0;
+    }
+
+    // sets holding the new one aren't minimal anymore
+    u32 n = 0;
+    for (u32 i = 0; i < ua->n_sets; i++) {
+        const u64* m = ua->masks[i];
+        if ((m[0] & mask[0]) == mask[0] && (m[1] & mask[1]) == mask[1]) continue;
+        ua->sizes[n]    = ua->sizes[i];
+        ua->masks[n][0] = m[0];
+        ua->masks[n][1] = m[1];
+        n++;
+    }
+    ua->n_sets = n;
+
+    u32 slot = ua->n_sets;
+    if (slot == UA_MAX_SETS) {
+        slot = 0;
+        for (u32 i = 1; i < ua->n_sets; i++) {
+            if (ua->sizes[i] > ua->sizes[slot]) slot = i;
+        }
+        if (ua->sizes[slot] <= size) return 0;
+    } else {
+        ua->n_sets++;
+    }
+
+    ua->sizes[slot]    = size;
+    ua->masks[slot][0] = mask[0];
+    ua->masks[slot][1] = mask[1];
+    return 1;
+}
+
+
+
+u8 ua_hit_all(const Unavoidables* ua, const u64* clues) {
+    for (u32 i = 0; i < ua->n_sets; i++) {
+        if (!(ua->masks[i][0] & clues[0]) && !(ua->masks[i][1] & clues[1])) return 0;
+    }
+    return 1;
+}
+
+
+
+// -- Search
+struct UAFill {
+    const u8*     grid;
+    Unavoidables* ua;
+    u8            cells[9 * UA_MAX_DIGITS];
+    u8            n_cells;
+    u16           digits;               // the cleared digits, BOARD_1 for 1
+    u16           units[N_UNITS];       // cleared digits placed per unit
+    u8            fill[BOARD_SIZE];
+    u32           n_fills;
+};
+
+void _ua_fill(UAFill* f, u8 k) {
+    if (f->n_fills >= UA_MAX_FILLS) return;
+    if (k == f->n_cells) {
+        u64 mask[2];
+        ua_diff(f->grid, f->fill, mask);
+        if (mask[0] | mask[1]) {
+            ua_add(f->ua, mask);
+            f->n_fills++;
+        }
+        return;
+    }
+
+    u8        idx   = f->cells[k];
+    const u8* units = CELL_UNITS(idx);
+    u16 open = f->digits & ~(f->units[units[0]] | f->units[units[1]] | f->units[units[2]]);
+    while (open) {
+        u16 bit = open & (0 - open);
+        open &= ~bit;
+
+        f->fill[idx] = BIT_DIGIT(bit);
+        for (u8 u = 0; u < 3; u++) f->units[units[u]] |= bit;
+        _ua_fill(f, k + 1);
+        for (u8 u = 0; u < 3; u++) f->units[units[u]] &= ~bit;
+    }
+}
+
+u32 ua_find(const u8* grid, Unavoidables* ua, u8 max_digits) {
+    ua->n_sets = 0;
+
+    UAFill f;
+    f.grid = grid;
+    f.ua   = ua;
+
+    for (u16 digits = 1; digits <= BOARD_ALL; digits++) {
+        u8 n_digits = BIT_COUNT(digits);
+        if (n_digits < 2 || n_digits > max_digits) continue;
+
+        f.digits  = digits;
+        f.n_cells = 0;
+        f.n_fills = 0;
+        memset(f.units, 0, sizeof(f.units));
+        memcpy(f.fill, grid, BOARD_SIZE);
+        for (u8 i = 0; i < BOARD_SIZE; i++) {
+            if (digits & (1 << (grid[i] - 1))) f.cells[f.n_cells++] = i;
+        }
+        _ua_fill(&f, 0);
+    }
+
+    // smallest first, the search takes them in this order
+    for (u32 i = 1; i < ua->n_sets; i++) {
+        u8  size    = ua->sizes[i];
+        u64 mask[2] = {ua->masks[i][0], ua->masks[i][1]};
+        u32 j = i;
+        for (; j > 0 && ua->sizes[j - 1] > size; j--) {
+            ua->sizes[j]    = ua->sizes[j - 1];
+            ua->masks[j][0] = ua->masks[j - 1][0];
+            ua->masks[j][1] = ua->masks[j - 1][1];
+        }
+        ua->sizes[j]    = size;
+        ua->masks[j][0] = mask[0];
+        ua->masks[j][1] = mask[1];
+    }
+    return ua->n_sets;
+}
@@ -0,0 +1,52 @@
+#ifndef PROJ_UNAVOID_H
+#define PROJ_UNAVOID_H
+
+// local
+#include "proj_types.h"
+#include "proj_board.h"
+
+// system
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+
+
+/*
+    unavoidable sets
+
+    a set of cells is unavoidable in a grid if its digits can be moved
+    around into another valid grid with every other cell left as it is, so
+    every puzzle with that grid as its solution has a clue inside it. the
+    small ones are found by clearing every cell of 2 or 3 digits and
+    listing the other ways to fill those cells back in, the cells a fill
+    changes are one set.
+
+    sets are 81 bit masks, cell i is bit i & 63 of [i >> 6]. only minimal
+    sets are kept (none holds another), sorted smallest first.
+*/
+#define UA_MAX_SETS         512
+#define UA_WORDS            (UA_MAX_SETS / 64)
+#define UA_MAX_DIGITS       3       // largest digit subset that can be cleared
+#define UA_MAX_FILLS        64      // other fills listed per subset
+
+struct Unavoidables {
+    u32 n_sets = 0;
+    u8  sizes[UA_MAX_SETS];
+    u64 masks[UA_MAX_SETS][2];
+};
+
+// the cells two grids disagree on
+void ua_diff(const u8* grid, const u8* other, u64* mask);
+
+// keeps the sets minimal, 0 if an existing set is inside mask. when full
+// the largest set makes room for a smaller one
+u8   ua_add(Unavoidables* ua, const u64* mask);
+
+// every set found through the subsets of up to max_digits digits, smallest first
+u32  ua_find(const u8* grid, Unavoidables* ua, u8 max_digits);
+
+// 1 if clues (a mask like the sets) has a cell in every set
+u8   ua_hit_all(const Unavoidables* ua, const u64* clues);
+
+#endif
@@ -0,0 +1,914 @@
+#include "proj_verify.h"
+
+
+// -- Adapters
+// make_progress on every pencil cell and stage, until a whole sweep changes nothing
+u32 _verify_sweep(u16* board) {
+    u32 calls  = 0;
+    u8  change = 1;
+    while (change) {
+        change = 0;
+        for (u8 i = 0; i < BOARD_SIZE; i++) {
+            for (u8 stage = 0; stage < 3; stage++) {
+                u8 status = make_progress(board, board_tables.col[i], board_tables.row[i], stage, 1, NULL);
+                calls += status != PROGRESS_INV_CELL;
+                change |= status == PROGRESS_STATE_CHANGE || status == PROGRESS_SET_CELL;
+            }
+        }
+    }
+    return calls;
+}
+
+// reference of the solve kind, the solution only if it's the only one
+u8 _verify_search_unique(u16* board, SolverStats* stats) {
+    SolverContext ctx;
+    solver_load(&ctx, board);
+    if (solver_count(&ctx, 2, stats) != 1) return 0;
+
+    for (u8 i = 0; i < BOARD_SIZE; i++) {
+        if (board[i] & BOARD_FLAG_STATIC) continue;
+        board[i] = (board[i] & BOARD_FLAGS & ~u16(BOARD_FLAG_PENCIL)) | (1 << (ctx.digits[i] - 1));
+    }
+    return 1;
+}
+
+// reference of the fixpoint kind
+u8 _verify_progress_sweep(u16* board, SolverStats* stats) {
+    _verify_sweep(board);
+    return 1;
+}
+
+BoardValidator verify_validator;
+LogicPipeline  verify_logic;
+u8             verify_logic_ready = 0;
+
+u8 verify_validate_incremental(u16* board) {
+    return validate_incremental(&verify_validator, board);
+}
+
+u8 verify_logic_solve(u16* board, SolverStats* stats) {
+    if (!verify_logic_ready) {
+        logic_init(&verify_logic, 1);
+        verify_logic_ready = 1;
+    }
+    return logic_solve_board(board, &verify_logic, stats);
+}
+
+u8 verify_progress_queue(u16* board, SolverStats* stats) {
+    ProgressQueue q;
+    queue_init(&q, board);
+    while (queue_step(&q, board, stats) != PROGRESS_FIXPOINT);
+    return 1;
+}
+
+
+
+// -- Registry
+VerifyKernel verify_kernels_table[N_VERIFY_KINDS][VERIFY_MAX_KERNELS];
+u8           verify_n_kernels[N_VERIFY_KINDS] = {0};
+
+u8 _verify_add(u8 kind, const char* name) {
+    if (verify_n_kernels[kind] == VERIFY_MAX_KERNELS) {
+        printf("[Verify] too many kernels, dropped %s\n", name);
+        return 0;
+    }
+    VerifyKernel* k = &verify_kernels_table[kind][verify_n_kernels[kind]++];
+    memset(k, 0, sizeof(VerifyKernel));
+    k->name = name;
+    return 1;
+}
+
+void verify_add_validate(const char* name, ValidateKernel fn) {
+    if (_verify_add(VERIFY_VALIDATE, name)) verify_kernels_table[VERIFY_VALIDATE][verify_n_kernels[VERIFY_VALIDATE] - 1].validate = fn;
+}
+
+void verify_add_fast(const char* name, FastKernel fn) {
+    if (_verify_add(VERIFY_FAST, name)) verify_kernels_table[VERIFY_FAST][verify_n_kernels[VERIFY_FAST] - 1].fast = fn;
+}
+
+void verify_add_progress(const char* name, ProgressKernel fn) {
+    if (_verify_add(VERIFY_PROGRESS, name)) verify_kernels_table[VERIFY_PROGRESS][verify_n_kernels[VERIFY_PROGRESS] - 1].progress = fn;
+}
+
+void verify_add_solve(const char* name, FastKernel fn) {
+    if (_verify_add(VERIFY_SOLVE, name)) verify_kernels_table[VERIFY_SOLVE][verify_n_kernels[VERIFY_SOLVE] - 1].fast = fn;
+}
+
+void verify_add_fixpoint(const char* name, FastKernel fn) {
+    if (_verify_add(VERIFY_FIXPOINT, name)) verify_kernels_table[VERIFY_FIXPOINT][verify_n_kernels[VERIFY_FIXPOINT] - 1].fast = fn;
+}
+
+// kernels registered before the references are shifted up, the reference is always index 0
+void _verify_add_references() {
+    const char* names[N_VERIFY_KINDS] = {"validate_board_units", "fast_solve", "make_progress", "search_unique", "progress_sweep"};
+    for (u8 kind = 0; kind < N_VERIFY_KINDS; kind++) {
+        if (verify_n_kernels[kind] && !strcmp(verify_kernels_table[kind][0].name, names[kind])) continue;
+        if (verify_n_kernels[kind] == VERIFY_MAX_KERNELS) verify_n_kernels[kind]--;
+
+        for (u8 i = verify_n_kernels[kind]; i > 0; i--) {
+            verify_kernels_table[kind][i] = verify_kernels_table[kind][i - 1];
+        }
+        verify_n_kernels[kind]++;
+
+        VerifyKernel* ref = &verify_kernels_table[kind][0];
+        memset(ref, 0, sizeof(VerifyKernel));
+        ref->name = names[kind];
+        if (kind == VERIFY_VALIDATE) ref->validate = validate_board_units;
+        if (kind == VERIFY_FAST)     ref->fast     = fast_solve;
+        if (kind == VERIFY_PROGRESS) ref->progress = make_progress;
+        if (kind == VERIFY_SOLVE)    ref->fast     = _verify_search_unique;
+        if (kind == VERIFY_FIXPOINT) ref->fast     = _verify_progress_sweep;
+    }
+}
+
+
+
+// -- Random Boards
+void _verify_shuffle(Rng* rng, u8* a, u8 n) {
+    for (u8 i = n - 1; i > 0; i--) {
+        u8 j   = u8(rng_below(rng, i + 1));
+        u8 tmp = a[i]; a[i] = a[j]; a[j] = tmp;
+    }
+}
+
+// a valid grid -- the shifted pattern grid under random band, stack, row,
+// col and digit permutations and maybe a transposition
+void _verify_grid(Rng* rng, u8* grid) {
+    u8 digits[9] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+    u8 bands[3]  = {0, 1, 2};
+    u8 stacks[3] = {0, 1, 2};
+    u8 rows[3][3];
+    u8 cols[3][3];
+    _verify_shuffle(rng, digits, 9);
+    _verify_shuffle(rng, bands,  3);
+    _verify_shuffle(rng, stacks, 3);
+    for (u8 k = 0; k < 3; k++) {
+        for (u8 j = 0; j < 3; j++) { rows[k][j] = j; cols[k][j] = j; }
+        _verify_shuffle(rng, rows[k], 3);
+        _verify_shuffle(rng, cols[k], 3);
+    }
+    u8 transposed = u8(rng_next(rng) & 0x1);
+
+    for (u8 r = 0; r < 9; r++) {
+        for (u8 c = 0; c < 9; c++) {
+            u8 src_r = bands[r/3]*3  + rows[r/3][r%3];
+            u8 src_c = stacks[c/3]*3 + cols[c/3][c%3];
+            u8 d     = digits[(src_r*3 + src_r/3 + src_c) % 9];
+            if (transposed) grid[c*9 + r] = d;
+            else            grid[r*9 + c] = d;
+        }
+    }
+}
+
+#define VERIFY_MODE_JUNK        0   // any mix of statics, ink and pencils
+#define VERIFY_MODE_PUZZLE      1   // a grid partly given, partly pencilled, a few mistakes
+#define VERIFY_MODE_SOLVED      2   // a full grid, sometimes with one wrong digit
+#define VERIFY_MODE_PENCILLED   3   // a puzzle after set_pencils, what the solvers usually see
+
+#define N_VERIFY_MODES          4
+
+void verify_case(u64 seed, u64 stream, VerifyCase* c) {
+    Rng rng;
+    rng_seed(&rng, seed, stream);
+    c->seed   = seed;
+    c->stream = stream;
+
+    u8 grid[BOARD_SIZE];
+    _verify_grid(&rng, grid);
+
+    u8 mode = u8(rng_below(&rng, N_VERIFY_MODES));
+    for (u8 i = 0; i < BOARD_SIZE; i++) {
+        u16 truth = 1 << (grid[i] - 1);
+        u16 wrong = 1 << rng_below(&rng, 9);
+        u16 cell  = 0;
+        u32 roll  = rng_below(&rng, 10);
+
+        if (mode == VERIFY_MODE_JUNK) {
+            cell = u16(rng_next(&rng)) & (BOARD_ALL | BOARD_FLAG_PENCIL | BOARD_FLAG_STATIC);
+            if (roll < 3)      cell = 0;
+            else if (roll < 5) cell = BOARD_FLAG_STATIC | wrong;
+            else if (roll < 7) cell = wrong;
+        } else if (mode == VERIFY_MODE_SOLVED) {
+            cell = (roll < 4) ? (BOARD_FLAG_STATIC | truth) : truth;
+        } else {
+            if (roll < 3)      cell = BOARD_FLAG_STATIC | truth;
+            else if (roll < 4) cell = truth;
+            else if (roll < 5) cell = wrong;
+            else if (roll < 8) cell = BOARD_FLAG_PENCIL | truth | (u16(rng_next(&rng)) & BOARD_ALL);
+            else if (roll < 9) cell = BOARD_FLAG_PENCIL | BOARD_ALL;
+        }
+
+        // stale error / solve marks and ui flags the kernels have to keep
+        if (!rng_below(&rng, 8)) {
+            cell |= u16(rng_next(&rng)) & (BOARD_FLAGS & ~u16(BOARD_FLAG_PENCIL | BOARD_FLAG_STATIC));
+        }
+        c->board[i] = cell;
+    }
+
+    if (mode == VERIFY_MODE_SOLVED && !rng_below(&rng, 4)) {
+        u8 i = u8(rng_below(&rng, BOARD_SIZE));
+        c->board[i] = (c->board[i] & ~BOARD_ALL) | (1 << rng_below(&rng, 9));
+    }
+    if (mode == VERIFY_MODE_PENCILLED) set_pencils(c->board, u8(rng_next(&rng) & 0x1));
+
+    c->base_x      = u8(rng_below(&rng, 9));
+    c->base_y      = u8(rng_below(&rng, 9));
+    c->stage       = u8(rng_below(&rng, 3));
+    c->square_rule = u8(rng_next(&rng) & 0x1);
+}
+
+
+
+// -- Comparison
+u8 _verify_run(u8 kind, VerifyKernel* k, VerifyCase* c, u16* out) {
+    memcpy(out, c->board, sizeof(u16) * BOARD_SIZE);
+    if (kind == VERIFY_VALIDATE) return k->validate(out);
+    if (kind == VERIFY_PROGRESS) return k->progress(out, c->base_x, c->base_y, c->stage, c->square_rule, NULL);
+    return k->fast(out, NULL);
+}
+
+u8 _verify_differs(u8 kind, VerifyKernel* ref, VerifyKernel* k, VerifyCase* c) {
+    u16 expected[BOARD_SIZE];
+    u16 got[BOARD_SIZE];
+    u8  a = _verify_run(kind, ref, c, expected);
+    u8  b = _verify_run(kind, k,   c, got);
+
+    // giving up is fine, as long as the board is left alone
+    if (kind == VERIFY_SOLVE) {
+        if (!b) return memcmp(got, c->board, sizeof(got)) != 0;
+        return !a || memcmp(expected, got, sizeof(got));
+    }
+
+    // the rules don't commute, any fixpoint of the sweep will do
+    if (kind == VERIFY_FIXPOINT) {
+        u16 swept[BOARD_SIZE];
+        memcpy(swept, got, sizeof(swept));
+        _verify_sweep(swept);
+        return a != b || memcmp(swept, got, sizeof(got));
+    }
+    return a != b || memcmp(expected, got, sizeof(got));
+}
+
+// greedy shrink, keeps any simplification of a cell that still disagrees
+void _verify_minimize(u8 kind, VerifyKernel* ref, VerifyKernel* k, VerifyCase* c) {
+    u8 shrunk = 1;
+    while (shrunk) {
+        shrunk = 0;
+
+        if (c->square_rule) {
+            c->square_rule = 0;
+            if (_verify_differs(kind, ref, k, c)) shrunk = 1;
+            else c->square_rule = 1;
+        }
+
+        for (u8 i = 0; i < BOARD_SIZE; i++) {
+            u16 cell = c->board[i];
+            if (!cell) continue;
+
+            // empty, no ui flags, one flag less, one candidate less
+            u16 tries[2 + 16];
+            u8  n_tries = 0;
+            tries[n_tries++] = 0;
+            tries[n_tries++] = cell & (BOARD_ALL | BOARD_FLAG_PENCIL | BOARD_FLAG_STATIC);
+            for (u8 b = 9; b < 16; b++) {
+                if (cell & (1 << b)) tries[n_tries++] = cell & ~u16(1 << b);
+            }
+            for (u8 d = 0; d < 9 && BIT_COUNT(cell) > 1; d++) {
+                if (cell & (1 << d)) tries[n_tries++] = cell & ~u16(1 << d);
+            }
+
+            // every try is smaller than the cell, so taking one always terminates
+            for (u8 t = 0; t < n_tries; t++) {
+                if (tries[t] == cell) continue;
+                c->board[i] = tries[t];
+                if (_verify_differs(kind, ref, k, c)) { shrunk = 1; break; }
+                c->board[i] = cell;
+            }
+        }
+    }
+}
+
+void _verify_report(u8 kind, VerifyKernel* ref, VerifyKernel* k, VerifyCase* c) {
+    u16 expected[BOARD_SIZE];
+    u16 got[BOARD_SIZE];
+    u8  a = _verify_run(kind, ref, c, expected);
+    u8  b = _verify_run(kind, k,   c, got);
+
+    printf("[Verify] %s disagrees with %s, case seed 0x%016llx stream %llu\n", k->name, ref->name, c->seed, c->stream);
+    if (kind == VERIFY_PROGRESS) {
+        printf("[Verify] x %u  y %u  stage %u  square rule %u\n", c->base_x, c->base_y, c->stage, c->square_rule);
+    }
+
+    printf("[Verify] minimized input\n");
+    for (u8 y = 0; y < 9; y++) {
+        printf("    ");
+        for (u8 x = 0; x < 9; x++) printf("%04x ", c->board[IDX(x,y)]);
+        printf("\n");
+    }
+
+    printf("[Verify] returned %u, expected %u\n", b, a);
+    for (u8 i = 0; i < BOARD_SIZE; i++) {
+        if (expected[i] == got[i]) continue;
+        printf("[Verify] cell %2u (x %u, y %u) :: %04x, expected %04x\n",
+               i, board_tables.col[i], board_tables.row[i], got[i], expected[i]);
+    }
+}
+
+
+
+// -- Harness
+u8 verify_kernels(u64 seed, u32 count) {
+    _verify_add_references();
+
+    u64 ticks[N_VERIFY_KINDS][VERIFY_MAX_KERNELS] = {{0}};
+    u16 out[BOARD_SIZE];
+
+    // the solves and fixpoints take microseconds, one run is plenty
+    const u8 repeats[N_VERIFY_KINDS] = {VERIFY_REPEATS, VERIFY_REPEATS, VERIFY_REPEATS, 1, 1};
+
+    VerifyCase c;
+    for (u32 n = 0; n < count; n++) {
+        verify_case(seed, n, &c);
+
+        for (u8 kind = 0; kind < N_VERIFY_KINDS; kind++) {
+            VerifyKernel* ref = &verify_kernels_table[kind][0];
+            for (u8 i = 1; i < verify_n_kernels[kind]; i++) {
+                VerifyKernel* k = &verify_kernels_table[kind][i];
+                if (!_verify_differs(kind, ref, k, &c)) continue;
+
+                _verify_minimize(kind, ref, k, &c);
+                _verify_report(kind, ref, k, &c);
+                return 0;
+            }
+
+            // timings, only for the summary. a few runs a read so the
+            // clock isn't most of what the fast kernels measure
+            for (u8 i = 0; i < verify_n_kernels[kind]; i++) {
+                u64 start = stats_ticks();
+                for (u8 r = 0; r < repeats[kind]; r++) _verify_run(kind, &verify_kernels_table[kind][i], &c, out);
+                ticks[kind][i] += stats_ticks() - start;
+            }
+        }
+    }
+
+    // speedup over the reference, the copy of the board is in both
+    printf("[Verify] %u boards, seed 0x%016llx\n", count, seed);
+    for (u8 kind = 0; kind < N_VERIFY_KINDS; kind++) {
+        f64 ref_ns = f64(stats_ticks_to_ns(ticks[kind][0])) / f64(u64(count) * repeats[kind]);
+        for (u8 i = 0; i < verify_n_kernels[kind]; i++) {
+            f64 ns = f64(stats_ticks_to_ns(ticks[kind][i])) / f64(u64(count) * repeats[kind]);
+            if (i) printf("[Verify] %-24s %8.1f ns/board %6.1fx\n", verify_kernels_table[kind][i].name, ns, ref_ns / ns);
+            else   printf("[Verify] %-24s %8.1f ns/board  (reference)\n", verify_kernels_table[kind][i].name, ns);
+        }
+    }
+    return 1;
+}
+
+
+
+// -- Grids
+// a valid grid, then maybe two cells swapped or one digit out of range
+void _verify_broken_grid(Rng* rng, u8* grid) {
+    _verify_grid(rng, grid);
+
+    u32 roll = rng_below(rng, 4);
+    u8  i    = u8(rng_below(rng, BOARD_SIZE));
+    u8  j    = u8(rng_below(rng, BOARD_SIZE));
+    if (roll == 1) { u8 tmp = grid[i]; grid[i] = grid[j]; grid[j] = tmp; }
+    if (roll == 2) grid[i] = rng_below(rng, 2) ? 0 : u8(10 + rng_below(rng, 6));
+}
+
+u8 verify_grids(u64 seed, u32 count) {
+    u8*  bytes   = (u8*)  malloc(u64(count) * GRID_BYTES);
+    u8*  nibbles = (u8*)  calloc(u64(count) * GRID_NIBBLES, 1);
+    u8*  first   = (u8*)  malloc(count);
+    u64* pass    = (u64*) malloc(sizeof(u64) * ((count + 63) / 64));
+
+    Rng rng;
+    rng_seed(&rng, seed, 0);
+    for (u32 n = 0; n < count; n++) {
+        u8* grid = bytes + u64(n) * GRID_BYTES;
+        _verify_broken_grid(&rng, grid);
+
+        u8* packed = nibbles + u64(n) * GRID_NIBBLES;
+        for (u8 i = 0; i < BOARD_SIZE; i++) packed[i >> 1] |= grid[i] << (4 * (i & 0x1));
+    }
+
+    u8  ok = 1;
+    u64 ticks[3] = {0};
+    u8  formats[2] = {GRID_FORMAT_BYTES, GRID_FORMAT_NIBBLES};
+    for (u8 f = 0; f < 2 && ok; f++) {
+        u8* grids = f ? nibbles : bytes;
+
+        u64 start = stats_ticks();
+        u32 valid = check_grids(grids, count, formats[f], pass, first);
+        ticks[f] = stats_ticks() - start;
+
+        u32 expected_valid = 0;
+        for (u32 n = 0; n < count && ok; n++) {
+            u8 expected = check_grid(bytes + u64(n) * GRID_BYTES, GRID_FORMAT_BYTES);
+            u8 passed   = u8((pass[n >> 6] >> (n & 63)) & 0x1);
+            expected_valid += expected == GRID_VALID;
+            if (first[n] == expected && passed == (expected == GRID_VALID)) continue;
+
+            printf("[Verify] check_grids (%s) disagrees on grid %u :: unit %u, expected %u\n",
+                   f ? "nibbles" : "bytes", n, first[n], expected);
+            ok = 0;
+        }
+        if (ok && valid != expected_valid) {
+            printf("[Verify] check_grids (%s) counted %u valid grids, expected %u\n",
+                   f ? "nibbles" : "bytes", valid, expected_valid);
+            ok = 0;
+        }
+    }
+
+    if (ok) {
+        u64 start = stats_ticks();
+        volatile u32 sink = 0;
+        for (u32 n = 0; n < count; n++) sink += check_grid(bytes + u64(n) * GRID_BYTES, GRID_FORMAT_BYTES);
+        ticks[2] = stats_ticks() - start;
+
+        const char* names[3] = {"check_grids (bytes)", "check_grids (nibbles)", "check_grid"};
+        printf("[Verify] %u grids, seed 0x%016llx\n", count, seed);
+        for (u8 i = 0; i < 3; i++) {
+            printf("[Verify] %-24s %8.1f ns/grid\n", names[i], f64(stats_ticks_to_ns(ticks[i])) / f64(count));
+        }
+    }
+
+    free(bytes);
+    free(nibbles);
+    free(first);
+    free(pass);
+    return ok;
+}
+
+
+
+// -- Progress Worklist
+// the rules don't commute (the square rule reads pencils that another step
+// may have inked), so a different order can stop at a different fixpoint.
+// what has to hold is that the worklist leaves nothing a sweep would still
+// find, and never drops a digit of the grid
+u8 verify_progress(u64 seed, u32 count) {
+    Rng rng;
+    rng_seed(&rng, seed, 0);
+
+    u64 queue_calls = 0;
+    u64 sweep_calls = 0;
+    u32 same        = 0;
+    for (u32 n = 0; n < count; n++) {
+        // a random grid with 22 to 44 of its cells given, pencilled in
+        u8  grid[BOARD_SIZE];
+        u16 queued[BOARD_SIZE];
+        generate_grid(grid, &rng);
+        u32 clues = 22 + rng_below(&rng, 23);
+        for (u8 i = 0; i < BOARD_SIZE; i++) {
+            u8 given  = rng_below(&rng, BOARD_SIZE - i) < clues;
+            clues    -= given;
+            queued[i] = given ? u16(BOARD_FLAG_STATIC | (1 << (grid[i] - 1))) : BOARD_EMPTY;
+        }
+        set_pencils(queued, 1);
+
+        u16 swept[BOARD_SIZE];
+        memcpy(swept, queued, sizeof(swept));
+        sweep_calls += _verify_sweep(swept);
+
+        ProgressQueue q;
+        queue_init(&q, queued);
+        while (queue_step(&q, queued, NULL) != PROGRESS_FIXPOINT);
+        queue_calls += q.calls;
+        same += !memcmp(queued, swept, sizeof(swept));
+
+        u16 again[BOARD_SIZE];
+        memcpy(again, queued, sizeof(again));
+        _verify_sweep(again);
+
+        for (u8 i = 0; i < BOARD_SIZE; i++) {
+            if (again[i] == queued[i] && (queued[i] & (1 << (grid[i] - 1)))) continue;
+            printf("[Verify] progress worklist stopped short on puzzle %u, cell %u :: %04x, swept on %04x, grid digit %u\n",
+                   n, i, queued[i], again[i], grid[i]);
+            return 0;
+        }
+    }
+
+    printf("[Verify] %u puzzles, progress worklist at a fixpoint, %u the sweep's own :: %.1f calls vs %.1f swept\n",
+           count, same, f64(queue_calls) / f64(count), f64(sweep_calls) / f64(count));
+    return 1;
+}
+
+
+
+// -- Generation
+u8 verify_generate(u64 seed, u32 count) {
+    LogicPipeline rater;
+    logic_init(&rater, 1);
+
+    Rng rng;
+    rng_seed(&rng, seed, 0);
+
+    // every difficulty without symmetry, then every symmetry on hard puzzles
+    printf("[Verify] %u puzzles per run, seed 0x%016llx\n", count, seed);
+    for (u8 r = 0; r < N_DIFFICULTIES + N_SYMMETRIES - 1; r++) {
+        u8 d        = (r < N_DIFFICULTIES) ? r : DIFFICULTY_HARD;
+        u8 symmetry = (r < N_DIFFICULTIES) ? SYMMETRY_NONE : r - N_DIFFICULTIES + 1;
+        DifficultyRange       range  = difficulty_ranges[d];
+        const SymmetryOrbits* orbits = &symmetry_orbits[symmetry];
+
+        u64 ticks    = 0;
+        u32 clues    = 0;
+        u32 short_of = 0;
+        for (u32 n = 0; n < count; n++) {
+            u16 board[BOARD_SIZE];
+            u64 start = stats_ticks();
+            u32 score = generate_puzzle(board, range, GENERATE_BUDGET_US, symmetry, &rng, NULL);
+            ticks += stats_ticks() - start;
+
+            // below the band only when the budget ran out
+            u32 rated = logic_rate(board, &rater, NULL);
+            short_of += score < range.lo;
+            if (rated != score || score >= range.hi) {
+                printf("[Verify] generate_puzzle (%s, %s) scored %u, rated %u, band [%u, %u)\n",
+                       difficulty_names[d], symmetry_names[symmetry], score, rated, range.lo, range.hi);
+                return 0;
+            }
+            for (u8 o = 0; o < orbits->n_orbits; o++) {
+                u8 given = board[orbits->cells[o][0]] != BOARD_EMPTY;
+                for (u8 k = 1; k < orbits->size[o]; k++) {
+                    if ((board[orbits->cells[o][k]] != BOARD_EMPTY) == given) continue;
+                    printf("[Verify] generate_puzzle (%s, %s) broke the symmetry at cell %u\n",
+                           difficulty_names[d], symmetry_names[symmetry], orbits->cells[o][k]);
+                    return 0;
+                }
+            }
+            for (u8 i = 0; i < BOARD_SIZE; i++) clues += board[i] != BOARD_EMPTY;
+        }
+
+        // untimed, a seed digs the same puzzle every time
+        u16 replay[2][BOARD_SIZE];
+        for (u8 k = 0; k < 2; k++) {
+            Rng again;
+            rng_seed(&again, seed, r + 1);
+            generate_puzzle(replay[k], range, GENERATE_UNTIMED, symmetry, &again, NULL);
+        }
+        if (memcmp(replay[0], replay[1], sizeof(replay[0]))) {
+            printf("[Verify] generate_puzzle (%s, %s) dug two puzzles from one seed\n", difficulty_names[d], symmetry_names[symmetry]);
+            return 0;
+        }
+
+        f64 ms = f64(stats_ticks_to_ns(ticks)) / 1e6 / f64(count);
+        printf("[Verify] generate_puzzle (%-6s, %-10s) %8.3f ms/puzzle %8.1f puzzles/s %6.1f clues %4u out of budget\n",
+               difficulty_names[d], symmetry_names[symmetry], ms, 1000.0 / ms, f64(clues) / f64(count), short_of);
+    }
+    return 1;
+}
+
+
+
+// -- Minimality
+// 0 with the first difference printed, what names the variant
+u8 _verify_minimal_case(u16* board, ThreadPool* pool, TransTable* tt, u32 n, const char* what) {
+    u8 serial[BOARD_SIZE];
+    u8 pooled[BOARD_SIZE];
+    u8 first[BOARD_SIZE];
+    u8 raced[BOARD_SIZE];
+    u8 n_serial = check_minimal(board, NULL, serial, 0, NULL, NULL);
+    u8 n_pooled = check_minimal(board, pool, pooled, 0, tt, NULL);
+    u8 n_first  = check_minimal(board, NULL, first, 1, NULL, NULL);
+    u8 n_raced  = check_minimal(board, pool, raced, 1, tt, NULL);
+
+    u8 ok = n_pooled == n_serial && (n_serial == MINIMAL_NOT_UNIQUE || !memcmp(serial, pooled, n_serial));
+    if (n_serial == MINIMAL_NOT_UNIQUE) ok &= n_first == MINIMAL_NOT_UNIQUE && n_raced == MINIMAL_NOT_UNIQUE;
+    else if (!n_serial)                 ok &= !n_first && !n_raced;
+    else {
+        // serially the first clue in index order, pooled any that were in flight
+        ok &= n_first == 1 && first[0] == serial[0] && n_raced >= 1 && n_raced != MINIMAL_NOT_UNIQUE;
+        for (u8 i = 0; ok && i < n_raced; i++) ok &= memchr(serial, raced[i], n_serial) != NULL;
+    }
+    if (ok) return 1;
+
+    printf("[Verify] check_minimal disagrees on puzzle %u (%s) :: serial %u, pooled %u, first %u, pooled first %u\n",
+           n, what, n_serial, n_pooled, n_first, n_raced);
+    return 0;
+}
+
+u8 verify_minimal(u64 seed, u32 count) {
+    Rng rng;
+    rng_seed(&rng, seed, 0);
+
+    ThreadPool pool;
+    pool_init(&pool, VERIFY_MINIMAL_THREADS);
+    TransTable tt;
+    tt_init(&tt, 16, 0);
+
+    u8  ok        = 1;
+    u32 redundant = 0;
+    for (u32 n = 0; ok && n < count; n++) {
+        u16 board[BOARD_SIZE];
+        generate_puzzle(board, difficulty_ranges[n % N_DIFFICULTIES], GENERATE_UNTIMED, n % N_SYMMETRIES, &rng, NULL);
+
+        SolverContext ctx;
+        solver_load(&ctx, board);
+        solver_count(&ctx, 1, NULL);
+
+        u8 found[BOARD_SIZE];
+        u8 n_found = check_minimal(board, NULL, found, 0, NULL, NULL);
+        redundant += n_found;
+        ok = _verify_minimal_case(board, &pool, &tt, n, "as dug");
+
+        // a few cells of the solution given back, those are redundant for sure
+        u16 more[BOARD_SIZE];
+        memcpy(more, board, sizeof(more));
+        for (u8 k = 0; k < 4; k++) {
+            u8 i = u8(rng_below(&rng, BOARD_SIZE));
+            more[i] = BOARD_FLAG_STATIC | (1 << (ctx.digits[i] - 1));
+        }
+        ok = ok && _verify_minimal_case(more, &pool, &tt, n, "clues put back");
+
+        // and a clue that isn't redundant taken out, no longer unique
+        u8 i = u8(rng_below(&rng, BOARD_SIZE));
+        while (!(board[i] & BOARD_FLAG_STATIC) || memchr(found, i, n_found)) i = (i + 1) % BOARD_SIZE;
+        board[i] = BOARD_EMPTY;
+        ok = ok && _verify_minimal_case(board, &pool, &tt, n, "a clue short");
+    }
+
+    if (ok) {
+        printf("[Verify] %u puzzles, check_minimal pooled, serial and first only agree :: %.1f redundant clues per puzzle, %.1f%% table hits\n",
+               count, f64(redundant) / f64(count), 100.0 * tt_hit_rate(&tt));
+    }
+    tt_free(&tt);
+    pool_free(&pool);
+    return ok;
+}
+
+
+
+// -- Counting
+u8 verify_count(u64 seed, u32 count) {
+    Rng rng;
+    rng_seed(&rng, seed, 0);
+
+    ThreadPool pool;
+    pool_init(&pool, 0);
+
+    u8  ok    = 1;
+    u64 ticks = 0;
+    for (u32 n = 0; ok && n < count; n++) {
+        u16 board[BOARD_SIZE];
+        generate_puzzle(board, difficulty_ranges[n % N_DIFFICULTIES], GENERATE_UNTIMED, SYMMETRY_NONE, &rng, NULL);
+        for (u32 taken = 0; taken < 1 + n % 5;) {
+            u8 i = u8(rng_below(&rng, BOARD_SIZE));
+            if (board[i] == BOARD_EMPTY) continue;
+            board[i] = BOARD_EMPTY;
+            taken++;
+        }
+
+        u32  solutions = count_solutions(board, VERIFY_COUNT_LIMIT, NULL, NULL);
+        u64  start     = stats_ticks();
+        u128 bands     = count_bands(board, &pool, NULL);
+        ticks += stats_ticks() - start;
+
+        // past the limit the search only says there are at least that many
+        ok = (solutions < VERIFY_COUNT_LIMIT) ? u128_equal(bands, u128_from(solutions))
+                                              : (bands.hi || bands.lo >= VERIFY_COUNT_LIMIT);
+        if (!ok) {
+            char text[48];
+            u128_to_string(bands, text);
+            printf("[Verify] count_bands found %s solutions on puzzle %u, count_solutions %u\n", text, n, solutions);
+        }
+    }
+
+    u16 empty[BOARD_SIZE] = {0};
+    char text[48];
+    u64 start = stats_ticks();
+    u128_to_string(count_bands(empty, &pool, NULL), text);
+    f64 empty_ms = f64(stats_ticks_to_ns(stats_ticks() - start)) / 1e6;
+    if (ok && strcmp(text, VERIFY_EMPTY_GRID)) {
+        printf("[Verify] count_bands found %s grids, there are %s\n", text, VERIFY_EMPTY_GRID);
+        ok = 0;
+    }
+
+    if (ok) {
+        printf("[Verify] %u puzzles, count_bands matches count_solutions, %.1f ms each :: %s grids in %.1f ms\n",
+               count, f64(stats_ticks_to_ns(ticks)) / 1e6 / f64(count), text, empty_ms);
+    }
+    pool_free(&pool);
+    return ok;
+}
+
+
+
+// -- Symmetric Search
+struct _VerifyExpand {
+    u8* grids;
+    u32 n_grids;
+};
+
+void _verify_emit(u8* digits, u64 weight, void* user) {
+    _VerifyExpand* e = (_VerifyExpand*) user;
+    if (e->n_grids < VERIFY_EXPAND_LIMIT) memcpy(&e->grids[e->n_grids * BOARD_SIZE], digits, BOARD_SIZE);
+    e->n_grids++;
+}
+
+int _verify_grid_order(const void* a, const void* b) {
+    return memcmp(a, b, BOARD_SIZE);
+}
+
+// at least given clues in pairs a half turn swaps, moved by a random element
+// of the group. row r, col c of the pattern holds 3*(r%3) + r/3 + c (mod 9),
+// a half turn takes that to 7 minus it, the same grid relabeled
+void _verify_half_turn(Rng* rng, u8 given, u16* board) {
+    u8 clues[BOARD_SIZE] = {0};
+    u8 moved[BOARD_SIZE];
+    for (u8 n = 0; n < given;) {
+        u8 i = u8(rng_below(rng, BOARD_SIZE));
+        if (clues[i]) continue;
+
+        u8 j = BOARD_SIZE - 1 - i;
+        clues[i] = (3 * (i / 9 % 3) + i / 27 + i % 9) % 9 + 1;
+        clues[j] = (3 * (j / 9 % 3) + j / 27 + j % 9) % 9 + 1;
+        n += (i == j) ? 1 : 2;
+    }
+
+    Transform t;
+    random_transform(&t, rng);
+    apply_transform(&t, clues, moved);
+    for (u8 i = 0; i < BOARD_SIZE; i++) board[i] = moved[i] ? u16(BOARD_FLAG_STATIC | (1 << (moved[i] - 1))) : BOARD_EMPTY;
+}
+
+u8 verify_symmetric(u64 seed, u32 count) {
+    Rng rng;
+    rng_seed(&rng, seed, 0);
+
+    SymmetryWork work;
+    symmetry_init(&work);
+    _VerifyExpand expand;
+    expand.grids = (u8*) malloc(VERIFY_EXPAND_LIMIT * BOARD_SIZE);
+
+    u8  ok       = 1;
+    u32 expanded = 0;
+    u64 group    = 0;
+    u64 searched = 0;
+    u64 leaves   = 0;
+    for (u32 n = 0; ok && n < count; n++) {
+        u16 board[BOARD_SIZE];
+        if (n & 1) {
+            // a puzzle with every clue of two digits gone, they can swap
+            generate_puzzle(board, difficulty_ranges[n / 2 % N_DIFFICULTIES], GENERATE_UNTIMED, SYMMETRY_NONE, &rng, NULL);
+            u16 gone = u16(1 << rng_below(&rng, 9));
+            while (BIT_COUNT(gone) < 2) gone |= u16(1 << rng_below(&rng, 9));
+            for (u8 i = 0; i < BOARD_SIZE; i++) if (board[i] & gone) board[i] = BOARD_EMPTY;
+        } else {
+            _verify_half_turn(&rng, 24 + n % 12, board);
+        }
+
+        OrbitCount orbits;
+        expand.n_grids = 0;
+        u32 solutions  = count_solutions(board, VERIFY_COUNT_LIMIT, NULL, NULL);
+        u8  small      = solutions <= VERIFY_EXPAND_LIMIT;
+        u64 total      = search_symmetric(board, VERIFY_COUNT_LIMIT, &work, small ? _verify_emit : NULL, 1, &expand, &orbits, NULL);
+        group    += orbits.group_size;
+        searched += orbits.solutions;
+        leaves   += orbits.representatives;
+
+        // past the limit both only say there are at least that many. below
+        // it, no limit at all has to give the same (the split over an orbit
+        // mustn't overflow)
+        ok = (solutions < VERIFY_COUNT_LIMIT) ? total == solutions : total >= VERIFY_COUNT_LIMIT;
+        ok = ok && (solutions >= VERIFY_COUNT_LIMIT || search_symmetric(board, ~0ull, &work, NULL, 0, NULL, NULL, NULL) == solutions);
+        ok = ok && orbits.group_size >= 2 && orbits.representatives <= total;
+        ok = ok && (!orbits.orbits || (orbits.orbits <= total && orbits.orbits * orbits.group_size >= total));
+        if (!ok) {
+            printf("[Verify] search_symmetric found %llu solutions on puzzle %u, count_solutions %u :: %llu orbits, group of %llu\n",
+                   total, n, solutions, orbits.orbits, orbits.group_size);
+            break;
+        }
+        if (!small) continue;
+
+        // every expanded solution once, a grid, on the clues
+        ok = expand.n_grids == solutions;
+        qsort(expand.grids, expand.n_grids, BOARD_SIZE, _verify_grid_order);
+        for (u32 k = 0; ok && k < expand.n_grids; k++) {
+            u8* grid = &expand.grids[k * BOARD_SIZE];
+            ok = check_grid(grid, GRID_FORMAT_BYTES) == GRID_VALID;
+            ok = ok && (!k || memcmp(grid - BOARD_SIZE, grid, BOARD_SIZE));
+            for (u8 i = 0; ok && i < BOARD_SIZE; i++) ok = !board[i] || BIT_DIGIT(board[i]) == grid[i];
+        }
+        if (!ok) printf("[Verify] search_symmetric expanded %u solutions of puzzle %u wrong, count_solutions %u\n", expand.n_grids, n, solutions);
+        expanded++;
+    }
+
+    if (ok) {
+        printf("[Verify] %u symmetric puzzles, search_symmetric matches count_solutions, %u expanded :: group of %.1f, %.1f%% of the leaves searched\n",
+               count, expanded, f64(group) / f64(count), 100.0 * f64(leaves) / f64(searched));
+    }
+    free(expand.grids);
+    symmetry_free(&work);
+    return ok;
+}
+
+
+
+// -- Canonical Form
+// every element of the group, straight: how many map the clues onto
+// themselves under some relabeling of the digits that are there
+u32 _verify_automorphisms(const u8* digits) {
+    u32 n = 0;
+    for (u8 t = 0; t < 2; t++) {
+        for (u32 r = 0; r < N_COL_PERMS; r++) {
+            const u8* rows = col_perms.cols[r];
+            for (u32 c = 0; c < N_COL_PERMS; c++) {
+                const u8* cols = col_perms.cols[c];
+                u8 map[10]  = {0};
+                u8 used[10] = {0};
+                u8 i = 0;
+                for (; i < BOARD_SIZE; i++) {
+                    u8 row = board_tables.row[i];
+                    u8 col = board_tables.col[i];
+                    u8 from = digits[t ? cols[col]*9 + rows[row] : rows[row]*9 + cols[col]];
+                    u8 to   = digits[i];
+                    if (!from != !to) break;
+                    if (!from) continue;
+                    if (!map[from]) {
+                        if (used[to]) break;
+                        map[from] = to;
+                        used[to]  = 1;
+                    }
+                    if (map[from] != to) break;
+                }
+                n += i == BOARD_SIZE;
+            }
+        }
+    }
+    return n;
+}
+
+u8 verify_canon(u64 seed, u32 count) {
+    Rng rng;
+    rng_seed(&rng, seed, 0);
+
+    CanonWork work;
+    canon_init(&work);
+    Canon* canon = (Canon*) malloc(sizeof(Canon) * 2);
+
+    u8  ok      = 1;
+    u64 group   = 0;
+    u64 ticks   = 0;
+    u32 counted = 0;
+    for (u32 n = 0; ok && n < count; n++) {
+        // dug puzzles of every symmetry, and half turn seeds with a group
+        u16 board[BOARD_SIZE];
+        if (n & 1) _verify_half_turn(&rng, 24 + n % 12, board);
+        else       generate_puzzle(board, difficulty_ranges[n / 2 % N_DIFFICULTIES], GENERATE_UNTIMED, n / 2 % N_SYMMETRIES, &rng, NULL);
+
+        u8 digits[BOARD_SIZE];
+        u8 moved[BOARD_SIZE];
+        u8 image[BOARD_SIZE];
+        board_to_digits(board, digits);
+        Transform t;
+        random_transform(&t, &rng);
+        apply_transform(&t, digits, moved);
+
+        u64 start = stats_ticks();
+        canonicalize(&work, digits, &canon[0]);
+        canonicalize(&work, moved, &canon[1]);
+        ticks += stats_ticks() - start;
+        group += canon[0].n_automorphisms;
+
+        // the same string from anywhere in the class, reached by to_minlex
+        apply_transform(&canon[0].to_minlex, digits, image);
+        ok = !memcmp(canon[0].minlex, canon[1].minlex, BOARD_SIZE) && !memcmp(image, canon[0].minlex, BOARD_SIZE);
+        ok = ok && canon[0].n_automorphisms == canon[1].n_automorphisms;
+        if (!ok) {
+            printf("[Verify] canonicalize of puzzle %u moved by the group differs :: %u vs %u automorphisms\n",
+                   n, canon[0].n_automorphisms, canon[1].n_automorphisms);
+            break;
+        }
+
+        // every automorphism kept maps the puzzle onto itself
+        u32 kept = canon[0].n_automorphisms < CANON_MAX_AUTOMORPHISMS ? canon[0].n_automorphisms : CANON_MAX_AUTOMORPHISMS;
+        for (u32 g = 0; ok && g < kept; g++) {
+            apply_transform(&canon[0].automorphisms[g], digits, image);
+            ok = !memcmp(image, digits, BOARD_SIZE);
+        }
+        if (!ok) {
+            printf("[Verify] canonicalize of puzzle %u kept an automorphism that moves it\n", n);
+            break;
+        }
+
+        // and there are as many as the whole group has, counted the slow way
+        if (n < VERIFY_CANON_GROUPS) {
+            u32 brute = _verify_automorphisms(digits);
+            ok = brute == canon[0].n_automorphisms;
+            counted++;
+            if (!ok) printf("[Verify] canonicalize found %u automorphisms of puzzle %u, the group has %u\n", canon[0].n_automorphisms, n, brute);
+        }
+    }
+
+    if (ok) {
+        printf("[Verify] %u puzzles, canonicalize is the same under the group, %u groups counted out :: %.3f ms each, group of %.1f\n",
+               count, counted, f64(stats_ticks_to_ns(ticks)) / 1e6 / f64(2 * count), f64(group) / f64(count));
+    }
+    free(canon);
+    canon_free(&work);
+    return ok;
+}
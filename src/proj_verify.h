@@ -0,0 +1,137 @@
+#ifndef PROJ_VERIFY_H
+#define PROJ_VERIFY_H
+
+// local
+#include "proj_types.h"
+#include "proj_board.h"
+#include "proj_stats.h"
+#include "proj_grids.h"
+#include "proj_logic.h"
+#include "proj_solver.h"
+#include "proj_count.h"
+
+// system
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+
+
+/*
+    differential harness for the board kernels
+
+    every registered kernel of a kind is run on the same seeded random
+    boards as the reference (validate_board_units, fast_solve, make_progress),
+    the return value and all 81 cells, flags included, have to match.
+    two kinds match looser, their kernels may land anywhere the reference
+    accepts:
+
+        solve       a solve that gives up returns 0 and leaves the board,
+                    one that returns 1 has the unique solution the search
+                    (search_unique) writes
+        fixpoint    a sweep of make_progress over every cell and stage
+                    (progress_sweep) finds nothing left on the kernel's board
+
+    a disagreement is shrunk to a small reproducer before it's reported.
+    the summary has the time per board and the speedup over the reference.
+*/
+#define VERIFY_VALIDATE         0
+#define VERIFY_FAST             1
+#define VERIFY_PROGRESS         2
+#define VERIFY_SOLVE            3
+#define VERIFY_FIXPOINT         4
+
+#define N_VERIFY_KINDS          5
+#define VERIFY_MAX_KERNELS      8
+
+#define VERIFY_SEED             0x5EED5EED5EED5EEDull
+#define VERIFY_BOARDS           (1 << 20)
+#define VERIFY_GRIDS            (1 << 18)
+#define VERIFY_PUZZLES          64
+#define VERIFY_FIXPOINTS        1024
+#define VERIFY_MINIMAL          128
+#define VERIFY_MINIMAL_THREADS  4           // more than the cores, so the pool races
+#define VERIFY_COUNTS           16
+#define VERIFY_COUNT_LIMIT      (1 << 16)
+#define VERIFY_EMPTY_GRID       "6670903752021072936960"
+#define VERIFY_SYMMETRIC        32
+#define VERIFY_EXPAND_LIMIT     4096        // solutions expanded and checked one by one
+#define VERIFY_CANON            256
+#define VERIFY_CANON_GROUPS     16          // of those, automorphisms counted over the whole group
+#define VERIFY_REPEATS          8           // timed runs of a fast kernel per board
+
+typedef u8 (*ValidateKernel)(u16* board);
+typedef u8 (*FastKernel)(u16* board, SolverStats* stats);
+typedef u8 (*ProgressKernel)(u16* board, u8 base_x, u8 base_y, u8 stage, u8 square_rule, SolverStats* stats);
+
+struct VerifyKernel {
+    const char*    name;
+    ValidateKernel validate;
+    FastKernel     fast;                    // fast, solve and fixpoint kernels
+    ProgressKernel progress;
+};
+
+struct VerifyCase {
+    u64 seed;
+    u64 stream;
+    u16 board[BOARD_SIZE];
+
+    // make_progress arguments
+    u8  base_x;
+    u8  base_y;
+    u8  stage;
+    u8  square_rule;
+};
+
+// the reference of each kind is registered first, on the first run
+void verify_add_validate(const char* name, ValidateKernel fn);
+void verify_add_fast(const char* name, FastKernel fn);
+void verify_add_progress(const char* name, ProgressKernel fn);
+void verify_add_solve(const char* name, FastKernel fn);
+void verify_add_fixpoint(const char* name, FastKernel fn);
+
+// kernels that keep state or take more, as the harness calls them. the
+// validator and pipeline are the harness's own, carried from board to board
+u8   verify_validate_incremental(u16* board);
+u8   verify_logic_solve(u16* board, SolverStats* stats);
+u8   verify_progress_queue(u16* board, SolverStats* stats);
+
+// same seed and stream, same board. case n of a run is stream n
+void verify_case(u64 seed, u64 stream, VerifyCase* c);
+
+// runs count cases against every registered kernel, 0 on the first disagreement
+u8   verify_kernels(u64 seed, u32 count);
+
+// check_grids in both formats against check_grid, on valid and broken grids
+u8   verify_grids(u64 seed, u32 count);
+
+// the progress worklist run to its fixpoint, a sweep of make_progress over
+// every cell and stage has to find nothing more, and the grid's digits stay
+u8   verify_progress(u64 seed, u32 count);
+
+// count puzzles of every difficulty and then of every symmetry, each rated
+// in its band and symmetric, with the time per puzzle
+u8   verify_generate(u64 seed, u32 count);
+
+// check_minimal pooled with a shared table against serial, on generated
+// puzzles, the same with clues put back and a clue short of unique.
+// first_only has to find a clue of the full list, serially its first
+u8   verify_minimal(u64 seed, u32 count);
+
+// count_bands against count_solutions on puzzles with 1 to 5 clues taken
+// out, and on the empty grid against the known number of grids
+u8   verify_count(u64 seed, u32 count);
+
+// search_symmetric against count_solutions on clue sets with automorphisms,
+// half of them turned onto themselves by a half turn, half with two digits
+// left out. below VERIFY_EXPAND_LIMIT the expanded solutions have to be
+// valid grids over the clues, every one different
+u8   verify_symmetric(u64 seed, u32 count);
+
+// canonicalize of a puzzle and of the puzzle moved by a random element of
+// the group, the same minlex and automorphism count, to_minlex reaching it.
+// the automorphisms kept have to fix the puzzle, and on the first few the
+// count has to match a pass over the whole group
+u8   verify_canon(u64 seed, u32 count);
+
+#endif